@@ -0,0 +1,198 @@
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include "asset_pack.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 背景解碼完成的圖片；命中未壓縮的資源包項目時像素直接指向映射的記憶體
+struct DecodedImage {
+    std::string name;
+    std::string path;
+    sf::Image image;
+    const sf::Uint8* mappedPixels = nullptr;
+    sf::Vector2u mappedSize;
+    std::uint64_t contentHash = 0;
+    bool fromPack = false;
+    bool loaded = false;
+
+    const sf::Uint8* getPixels() const {
+        return mappedPixels ? mappedPixels : image.getPixelsPtr();
+    }
+
+    sf::Vector2u getSize() const {
+        return mappedPixels ? mappedSize : image.getSize();
+    }
+};
+
+// 解碼 decoded.path：資源包中有相同內容的項目時直接使用預先解碼的像素，否則解碼 PNG。
+// 結果寫入 decoded（loaded、fromPack 等），載入器與串流背景共用
+inline void decodeAsset(const AssetPack* pack, DecodedImage& decoded) {
+    std::vector<char> bytes;
+    if (!readFileBytes(decoded.path, bytes)) {
+        return;
+    }
+    decoded.contentHash = hashBytes(bytes.data(), bytes.size());
+    const AssetPackEntry* entry = pack ? pack->find(decoded.contentHash) : nullptr;
+    if (entry) {
+        std::vector<sf::Uint8> scratch;
+        const sf::Uint8* pixels = pack->getPixels(*entry, scratch);
+        if (pixels && entry->compression == PACK_RAW) {
+            decoded.mappedPixels = pixels;
+            decoded.mappedSize = sf::Vector2u(entry->width, entry->height);
+            decoded.fromPack = true;
+        } else if (pixels) {
+            decoded.image.create(entry->width, entry->height, pixels);
+            decoded.fromPack = true;
+        }
+    }
+    decoded.loaded = decoded.fromPack || decoded.image.loadFromMemory(bytes.data(), bytes.size());
+}
+
+// 只讀 PNG 檔頭（IHDR）取得圖片大小，不解碼；不是 PNG 時回傳 false
+inline bool readPngSize(const std::string& path, sf::Vector2u& size) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    unsigned char header[24];
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        !std::equal(signature, signature + 8, header) || !std::equal(header + 12, header + 16, "IHDR")) {
+        return false;
+    }
+    auto readBigEndian = [&](int offset) {
+        return (static_cast<unsigned int>(header[offset]) << 24) | (static_cast<unsigned int>(header[offset + 1]) << 16) |
+               (static_cast<unsigned int>(header[offset + 2]) << 8) | static_cast<unsigned int>(header[offset + 3]);
+    };
+    size = sf::Vector2u(readBigEndian(16), readBigEndian(20));
+    return true;
+}
+
+// 非同步資源載入器：以執行緒池平行解碼圖片（只產生 sf::Image），
+// 主執行緒再以 poll() 取回結果並自行上傳成 sf::Texture（OpenGL 只在主執行緒使用）。
+// 有資源包時先以來源檔內容雜湊查詢，命中就跳過 PNG 解碼
+class AssetLoader {
+private:
+    struct Request {
+        std::string name;
+        std::string path;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Request> requests;
+    std::deque<DecodedImage> results;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    const AssetPack* pack;
+    std::size_t packHits = 0;
+    std::size_t packMisses = 0;
+    std::size_t requestedCount = 0;
+    std::size_t completedCount = 0;
+    std::size_t collectedCount = 0;
+    bool stopping = false;
+
+    void workerLoop() {
+        for (;;) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this] { return stopping || !requests.empty(); });
+                if (stopping) {
+                    return;
+                }
+                request = std::move(requests.front());
+                requests.pop_front();
+            }
+
+            DecodedImage decoded;
+            decoded.name = request.name;
+            decoded.path = request.path;
+            decodeAsset(pack, decoded);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (decoded.fromPack) {
+                ++packHits;
+            } else if (decoded.loaded) {
+                ++packMisses;
+            }
+            results.push_back(std::move(decoded));
+            ++completedCount;
+        }
+    }
+
+public:
+    // threadCount 為 0 時使用硬體執行緒數；assetPack 必須比載入器活得久
+    explicit AssetLoader(unsigned int threadCount = 0, const AssetPack* assetPack = nullptr) : pack(assetPack) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            workers.emplace_back(&AssetLoader::workerLoop, this);
+        }
+    }
+
+    ~AssetLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // 排入解碼工作；依呼叫順序開始處理，需要先顯示的資源請先排
+    void request(const std::string& name, const std::string& path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back({name, path});
+            ++requestedCount;
+        }
+        wakeUp.notify_one();
+    }
+
+    // 主執行緒呼叫：取出一張已解碼完成的圖片，沒有時回傳 false
+    bool poll(DecodedImage& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (results.empty()) {
+            return false;
+        }
+        out = std::move(results.front());
+        results.pop_front();
+        ++collectedCount;
+        return true;
+    }
+
+    // 已完成解碼（不論成功與否）的比例，用於進度條
+    float getProgress() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return requestedCount == 0 ? 1.f : static_cast<float>(completedCount) / requestedCount;
+    }
+
+    // 從資源包取得的圖片數
+    std::size_t getPackHitCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return packHits;
+    }
+
+    // 需要重新解碼 PNG 的圖片數（資源包沒有或內容已改變）
+    std::size_t getPackMissCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return packMisses;
+    }
+
+    // 所有請求都已解碼並被 poll() 取走
+    bool isFinished() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return collectedCount == requestedCount;
+    }
+};
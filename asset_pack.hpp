@@ -0,0 +1,364 @@
+#pragma once
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include "fnv_hash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 預先解碼的資源包：把 PNG 轉成原始 RGBA 像素（可選 RLE 壓縮），
+// 以來源檔案內容的雜湊當作索引。執行時以記憶體映射開啟，
+// 內容沒變的圖片不必再解碼 PNG，可直接把映射的像素交給 sf::Texture::update。
+//
+// 檔案格式（little-endian）：
+//   標頭    : "GTA6PAK\0"、uint32 版本、uint32 項目數
+//   每個項目: uint64 內容雜湊、uint32 寬、uint32 高、uint32 壓縮方式、
+//             uint32 名稱長度、uint64 資料位移、uint64 資料大小、名稱
+//   資料區  : 各項目的像素資料，起點對齊 16 bytes
+
+const std::uint32_t ASSET_PACK_VERSION = 1;
+
+enum AssetPackCompression : std::uint32_t {
+    PACK_RAW = 0,
+    PACK_RLE = 1,
+};
+
+inline bool readFileBytes(const std::string& path, std::vector<char>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    const std::streamsize size = file.tellg();
+    file.seekg(0);
+    out.resize(static_cast<std::size_t>(size));
+    return size == 0 || static_cast<bool>(file.read(out.data(), size));
+}
+
+// 以 32 位元像素為單位的 RLE：控制字最高位元為 1 時代表「重複下一個像素 N 次」，
+// 否則代表「接下來 N 個像素原樣複製」
+inline void rleCompress(const sf::Uint8* pixels, std::size_t pixelCount, std::vector<sf::Uint8>& out) {
+    const std::uint32_t* source = reinterpret_cast<const std::uint32_t*>(pixels);
+    std::vector<std::uint32_t> words;
+    std::size_t i = 0;
+    while (i < pixelCount) {
+        std::size_t run = 1;
+        while (i + run < pixelCount && source[i + run] == source[i] && run < 0x7FFFFFFF) {
+            ++run;
+        }
+        if (run >= 3) {
+            words.push_back(0x80000000u | static_cast<std::uint32_t>(run));
+            words.push_back(source[i]);
+            i += run;
+            continue;
+        }
+
+        // 收集原樣像素，直到下一段夠長的重複出現
+        std::size_t literalStart = i;
+        while (i < pixelCount && i - literalStart < 0x7FFFFFFF) {
+            if (i + 2 < pixelCount && source[i] == source[i + 1] && source[i] == source[i + 2]) {
+                break;
+            }
+            ++i;
+        }
+        words.push_back(static_cast<std::uint32_t>(i - literalStart));
+        words.insert(words.end(), source + literalStart, source + i);
+    }
+    out.resize(words.size() * sizeof(std::uint32_t));
+    std::memcpy(out.data(), words.data(), out.size());
+}
+
+inline bool rleDecompress(const sf::Uint8* data, std::size_t size, std::size_t pixelCount, std::vector<sf::Uint8>& out) {
+    out.resize(pixelCount * 4);
+    std::uint32_t* target = reinterpret_cast<std::uint32_t*>(out.data());
+    const std::size_t wordCount = size / sizeof(std::uint32_t);
+    std::vector<std::uint32_t> words(wordCount);
+    std::memcpy(words.data(), data, wordCount * sizeof(std::uint32_t));
+
+    std::size_t written = 0;
+    std::size_t w = 0;
+    while (w < wordCount) {
+        const std::uint32_t control = words[w++];
+        const std::size_t count = control & 0x7FFFFFFF;
+        if (written + count > pixelCount) {
+            return false;
+        }
+        if (control & 0x80000000u) {
+            if (w >= wordCount) {
+                return false;
+            }
+            std::fill(target + written, target + written + count, words[w++]);
+        } else {
+            if (w + count > wordCount) {
+                return false;
+            }
+            std::memcpy(target + written, &words[w], count * sizeof(std::uint32_t));
+            w += count;
+        }
+        written += count;
+    }
+    return written == pixelCount;
+}
+
+struct AssetPackEntry {
+    std::string name;
+    std::uint64_t contentHash = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t compression = PACK_RAW;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+};
+
+// 唯讀資源包：POSIX 平台以 mmap 開啟，其他平台整檔讀入記憶體
+class AssetPack {
+private:
+    const sf::Uint8* data = nullptr;
+    std::size_t dataSize = 0;
+    std::vector<sf::Uint8> fallbackBuffer;
+    bool mapped = false;
+    std::unordered_map<std::uint64_t, AssetPackEntry> entries;
+
+    template <typename T>
+    bool readValue(std::size_t& cursor, T& value) const {
+        if (cursor + sizeof(T) > dataSize) {
+            return false;
+        }
+        std::memcpy(&value, data + cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+
+    bool parse() {
+        std::size_t cursor = 0;
+        char magic[8];
+        std::uint32_t version = 0, count = 0;
+        if (dataSize < sizeof(magic) || std::memcmp(data, "GTA6PAK", 8) != 0) {
+            return false;
+        }
+        cursor += sizeof(magic);
+        if (!readValue(cursor, version) || version != ASSET_PACK_VERSION || !readValue(cursor, count)) {
+            return false;
+        }
+
+        for (std::uint32_t i = 0; i < count; ++i) {
+            AssetPackEntry entry;
+            std::uint32_t nameLength = 0;
+            if (!readValue(cursor, entry.contentHash) || !readValue(cursor, entry.width) ||
+                !readValue(cursor, entry.height) || !readValue(cursor, entry.compression) ||
+                !readValue(cursor, nameLength) || !readValue(cursor, entry.offset) ||
+                !readValue(cursor, entry.size) || cursor + nameLength > dataSize) {
+                return false;
+            }
+            entry.name.assign(reinterpret_cast<const char*>(data + cursor), nameLength);
+            cursor += nameLength;
+            if (entry.offset + entry.size > dataSize) {
+                return false;
+            }
+            entries[entry.contentHash] = entry;
+        }
+        return true;
+    }
+
+public:
+    AssetPack() = default;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    ~AssetPack() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+#if !defined(_WIN32)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapping = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const sf::Uint8*>(mapping);
+                dataSize = static_cast<std::size_t>(info.st_size);
+                mapped = true;
+            }
+        }
+        ::close(fd);  // 映射在關閉檔案後仍然有效
+        if (!mapped) {
+            return false;
+        }
+#else
+        std::vector<char> bytes;
+        if (!readFileBytes(path, bytes)) {
+            return false;
+        }
+        fallbackBuffer.assign(bytes.begin(), bytes.end());
+        data = fallbackBuffer.data();
+        dataSize = fallbackBuffer.size();
+#endif
+        if (!parse()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#if !defined(_WIN32)
+        if (mapped) {
+            munmap(const_cast<sf::Uint8*>(data), dataSize);
+        }
+#endif
+        mapped = false;
+        data = nullptr;
+        dataSize = 0;
+        fallbackBuffer.clear();
+        entries.clear();
+    }
+
+    bool isOpen() const {
+        return data != nullptr;
+    }
+
+    std::size_t getEntryCount() const {
+        return entries.size();
+    }
+
+    const AssetPackEntry* find(std::uint64_t contentHash) const {
+        auto it = entries.find(contentHash);
+        return it == entries.end() ? nullptr : &it->second;
+    }
+
+    // 取得像素：未壓縮時直接指向映射的記憶體；壓縮時解壓到 scratch
+    const sf::Uint8* getPixels(const AssetPackEntry& entry, std::vector<sf::Uint8>& scratch) const {
+        const sf::Uint8* source = data + entry.offset;
+        const std::size_t pixelCount = static_cast<std::size_t>(entry.width) * entry.height;
+        if (entry.compression == PACK_RAW) {
+            return entry.size == pixelCount * 4 ? source : nullptr;
+        }
+        if (entry.compression == PACK_RLE && rleDecompress(source, entry.size, pixelCount, scratch)) {
+            return scratch.data();
+        }
+        return nullptr;
+    }
+};
+
+// 建置資源包：依序處理每個來源檔，內容未改變且已在 previous 裡的直接沿用，
+// 其餘重新解碼。先寫到暫存檔再改名，讀取中的舊映射不受影響
+inline bool buildAssetPack(const std::vector<std::string>& sourcePaths, const std::string& packPath,
+                           bool compress, const AssetPack* previous = nullptr) {
+    struct Item {
+        AssetPackEntry entry;
+        std::vector<sf::Uint8> payload;
+    };
+    std::vector<Item> items;
+
+    for (const auto& path : sourcePaths) {
+        std::vector<char> bytes;
+        if (!readFileBytes(path, bytes)) {
+            continue;  // 缺少的來源檔不放進資源包
+        }
+
+        Item item;
+        item.entry.name = path;
+        item.entry.contentHash = hashBytes(bytes.data(), bytes.size());
+
+        std::vector<sf::Uint8> scratch;
+        const sf::Uint8* pixels = nullptr;
+        sf::Image image;
+        const AssetPackEntry* cached = previous ? previous->find(item.entry.contentHash) : nullptr;
+        if (cached) {
+            pixels = previous->getPixels(*cached, scratch);
+            item.entry.width = cached->width;
+            item.entry.height = cached->height;
+        }
+        if (!pixels) {
+            if (!image.loadFromMemory(bytes.data(), bytes.size())) {
+                continue;
+            }
+            pixels = image.getPixelsPtr();
+            item.entry.width = image.getSize().x;
+            item.entry.height = image.getSize().y;
+        }
+
+        const std::size_t pixelCount = static_cast<std::size_t>(item.entry.width) * item.entry.height;
+        item.entry.compression = PACK_RAW;
+        if (compress) {
+            rleCompress(pixels, pixelCount, item.payload);
+            item.entry.compression = PACK_RLE;
+        }
+        // 壓縮沒有變小就存原始像素
+        if (!compress || item.payload.size() >= pixelCount * 4) {
+            item.payload.assign(pixels, pixels + pixelCount * 4);
+            item.entry.compression = PACK_RAW;
+        }
+        item.entry.size = item.payload.size();
+        items.push_back(std::move(item));
+    }
+
+    // 計算標頭大小後決定每筆資料的位移
+    std::uint64_t offset = 8 + sizeof(std::uint32_t) * 2;
+    for (const auto& item : items) {
+        offset += sizeof(std::uint64_t) * 3 + sizeof(std::uint32_t) * 4 + item.entry.name.size();
+    }
+    for (auto& item : items) {
+        offset = (offset + 15) & ~static_cast<std::uint64_t>(15);
+        item.entry.offset = offset;
+        offset += item.entry.size;
+    }
+
+    const std::string temporaryPath = packPath + ".tmp";
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    auto writeValue = [&](const void* value, std::size_t size) { std::fwrite(value, 1, size, file); };
+
+    const std::uint32_t version = ASSET_PACK_VERSION;
+    const std::uint32_t count = static_cast<std::uint32_t>(items.size());
+    writeValue("GTA6PAK", 8);
+    writeValue(&version, sizeof(version));
+    writeValue(&count, sizeof(count));
+    for (const auto& item : items) {
+        const std::uint32_t nameLength = static_cast<std::uint32_t>(item.entry.name.size());
+        writeValue(&item.entry.contentHash, sizeof(item.entry.contentHash));
+        writeValue(&item.entry.width, sizeof(item.entry.width));
+        writeValue(&item.entry.height, sizeof(item.entry.height));
+        writeValue(&item.entry.compression, sizeof(item.entry.compression));
+        writeValue(&nameLength, sizeof(nameLength));
+        writeValue(&item.entry.offset, sizeof(item.entry.offset));
+        writeValue(&item.entry.size, sizeof(item.entry.size));
+        writeValue(item.entry.name.data(), nameLength);
+    }
+    for (const auto& item : items) {
+        const long position = std::ftell(file);
+        static const char zeros[16] = {};
+        writeValue(zeros, static_cast<std::size_t>(item.entry.offset - position));
+        writeValue(item.payload.data(), item.payload.size());
+    }
+
+    const bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+#if defined(_WIN32)
+    std::remove(packPath.c_str());  // Windows 的 rename 不會覆蓋既有檔案
+#endif
+    if (!ok || std::rename(temporaryPath.c_str(), packPath.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const char* const ASSET_ROOT_ENVIRONMENT = "GTA6_ASSET_ROOT";
+const char* const ASSET_MANIFEST_FILE = "assets.manifest";
+
+// 資源根目錄：--asset-root <目錄> 優先，其次是環境變數 GTA6_ASSET_ROOT，
+// 都沒有時使用執行檔所在的目錄
+inline std::string findAssetRoot(int argc, char* argv[]) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--asset-root") == 0) {
+            return argv[i + 1];
+        }
+    }
+    const char* environment = std::getenv(ASSET_ROOT_ENVIRONMENT);
+    if (environment && *environment) {
+        return environment;
+    }
+    if (argc > 0) {
+        std::filesystem::path executableDirectory = std::filesystem::path(argv[0]).parent_path();
+        if (!executableDirectory.empty()) {
+            return executableDirectory.string();
+        }
+    }
+    return ".";
+}
+
+struct AssetManifestEntry {
+    std::string group;  // common 啟動時載入；levelN 是第 N 關需要的資源
+    std::string path;   // 相對於資源根目錄
+    std::uintmax_t size = 0;
+};
+
+// 把相對路徑解析到資源根目錄，並讀取資源清單（群組、路徑、大小），
+// 讓每一關只預載自己需要的檔案，也能在載入前發現缺少或過期的檔案
+class AssetResolver {
+private:
+    std::filesystem::path root;
+    std::vector<AssetManifestEntry> entries;
+
+public:
+    explicit AssetResolver(const std::string& rootDirectory) : root(rootDirectory) {}
+
+    std::string getRoot() const {
+        return root.string();
+    }
+
+    // 絕對路徑原樣回傳
+    std::string resolve(const std::string& relativePath) const {
+        std::filesystem::path path(relativePath);
+        return path.is_absolute() ? path.string() : (root / path).string();
+    }
+
+    // 清單格式：每行「群組 相對路徑 大小」，# 開頭為註解
+    bool loadManifest(const std::string& manifestPath = ASSET_MANIFEST_FILE) {
+        std::ifstream file(resolve(manifestPath));
+        if (!file) {
+            return false;
+        }
+        entries.clear();
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            AssetManifestEntry entry;
+            if (fields >> entry.group >> entry.path >> entry.size) {
+                entries.push_back(entry);
+            }
+        }
+        return true;
+    }
+
+    const std::vector<AssetManifestEntry>& getEntries() const {
+        return entries;
+    }
+
+    // 群組內所有資源的相對路徑，依清單順序
+    std::vector<std::string> getGroup(const std::string& group) const {
+        std::vector<std::string> paths;
+        for (const auto& entry : entries) {
+            if (entry.group == group) {
+                paths.push_back(entry.path);
+            }
+        }
+        return paths;
+    }
+
+    std::uintmax_t getGroupSize(const std::string& group) const {
+        std::uintmax_t total = 0;
+        for (const auto& entry : entries) {
+            if (entry.group == group) {
+                total += entry.size;
+            }
+        }
+        return total;
+    }
+
+    // 群組內缺少或大小與清單不符的檔案
+    std::vector<std::string> findMismatches(const std::string& group) const {
+        std::vector<std::string> mismatches;
+        for (const auto& entry : entries) {
+            if (entry.group != group) {
+                continue;
+            }
+            std::error_code error;
+            std::uintmax_t size = std::filesystem::file_size(resolve(entry.path), error);
+            if (error || size != entry.size) {
+                mismatches.push_back(entry.path);
+            }
+        }
+        return mismatches;
+    }
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include "asset_loader.hpp"
+#include "asset_pack.hpp"
+#include "background_animation.hpp"
+#include "profiler.hpp"
+#include "texture_atlas.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 預先載入的背景動畫：所有幀平行解碼後打包進圖集，換幀只改 texture rect，不切換材質。
+// 載入只發生一次，之後播放不再解碼；整段動畫都在記憶體中，所以只用於不超過預算的動畫
+// （見 createBackgroundAnimation()）。
+//
+// 幀在背景載入期間先顯示純色佔位畫面；全部解碼後打包，之後每次 update() 分批上傳
+class AtlasBackground : public BackgroundAnimation {
+private:
+    std::vector<std::string> framePaths;
+    mutable AssetLoader loader;  // 每個核心一個解碼執行緒
+    TextureAtlas atlas;
+    std::vector<DecodedImage> decodedFrames;  // 等待打包；映射的像素直接從資源包上傳
+    std::vector<TextureAtlas::Region> frames;
+    bool planned = false;
+    bool uploaded = false;
+    std::size_t decodedCount = 0;
+
+    sf::Sprite sprite;
+    sf::RectangleShape placeholder;
+    sf::Vector2f windowSize;
+    float frameTime;
+    float currentTime = 0.f;
+    std::size_t currentFrame = 0;
+
+    void collectDecodedFrames() {
+        DecodedImage decoded;
+        while (loader.poll(decoded)) {
+            ++decodedCount;
+            if (decoded.loaded) {
+                decodedFrames.push_back(std::move(decoded));
+            }
+        }
+    }
+
+    // 取得每一幀在圖集中的位置；載入失敗的幀會被略過
+    void resolveFrames() {
+        for (const auto& path : framePaths) {
+            if (atlas.contains(path)) {
+                frames.push_back(atlas.getRegion(path));
+            }
+        }
+        if (!frames.empty()) {
+            sprite.setTexture(*frames[0].texture);
+            sprite.setTextureRect(frames[0].rect);
+            // 每一幀大小相同，縮放只需設定一次
+            sprite.setScale(windowSize.x / frames[0].rect.width, windowSize.y / frames[0].rect.height);
+        }
+    }
+
+    // 解碼、打包與分批上傳；全部上傳後才開始播放
+    void load() {
+        collectDecodedFrames();
+        if (!planned && loader.isFinished()) {
+            for (auto& frame : decodedFrames) {
+                if (frame.mappedPixels) {
+                    atlas.addPixels(frame.path, frame.mappedPixels, frame.mappedSize);
+                } else {
+                    atlas.add(frame.path, std::move(frame.image));
+                }
+            }
+            decodedFrames.clear();
+            planned = true;
+            if (!atlas.plan()) {
+                uploaded = true;  // 無法建立圖集，維持佔位畫面
+                return;
+            }
+        }
+        if (planned && atlas.uploadPending(UPLOADS_PER_UPDATE) == 0) {
+            uploaded = true;
+            resolveFrames();
+        }
+    }
+
+public:
+    // paths 為完整路徑（依播放順序）；assetPack 必須比背景活得久
+    AtlasBackground(const std::vector<std::string>& paths, float frameDuration, const sf::Vector2f& size,
+                    const AssetPack* assetPack = nullptr)
+        : framePaths(paths), loader(0, assetPack), windowSize(size), frameTime(frameDuration) {
+        placeholder.setSize(windowSize);
+        placeholder.setFillColor(PLACEHOLDER_COLOR);
+        for (const auto& path : framePaths) {
+            loader.request(path, path);
+        }
+    }
+
+    void update(float deltaTime) override {
+        if (!uploaded) {
+            load();
+        }
+        if (frames.empty()) {
+            return;
+        }
+
+        currentTime += deltaTime;
+        if (currentTime >= frameTime) {
+            currentTime = 0.f;
+            const std::size_t previousFrame = currentFrame;
+            currentFrame = (currentFrame + 1) % frames.size();
+            // 只有跨頁時才需要換材質
+            if (frames[currentFrame].texture != frames[previousFrame].texture) {
+                sprite.setTexture(*frames[currentFrame].texture);
+            }
+            sprite.setTextureRect(frames[currentFrame].rect);
+        }
+    }
+
+    void draw(sf::RenderTarget& target) override {
+        if (frames.empty()) {
+            Profiler::get().draw(target, placeholder);
+        } else {
+            Profiler::get().draw(target, sprite);
+        }
+    }
+
+    const char* getModeName() const override {
+        return "atlas";
+    }
+
+    std::size_t getFrameCount() const override {
+        return framePaths.size();
+    }
+
+    std::size_t getDecodedCount() const override {
+        return decodedCount;
+    }
+
+    std::size_t getPackMissCount() const override {
+        return loader.getPackMissCount();
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <cstddef>
+
+// 背景動畫的共同介面：預先載入圖集（atlas_background.hpp）、shader 選幀（shader_background.hpp）
+// 與串流解碼（streaming_background.hpp），由 createBackgroundAnimation() 選擇。
+// update()、draw() 與統計只能在繪製執行緒（擁有 OpenGL context 的執行緒）呼叫
+class BackgroundAnimation {
+protected:
+    // 每次 update() 最多上傳到顯示卡的幀數，避免單幀卡頓
+    static const std::size_t UPLOADS_PER_UPDATE = 2;
+    // 第一幀準備好之前顯示的純色佔位畫面
+    static inline const sf::Color PLACEHOLDER_COLOR = sf::Color(30, 30, 40);
+
+public:
+    virtual ~BackgroundAnimation() = default;
+
+    // 推進播放時間（秒）
+    virtual void update(float deltaTime) = 0;
+
+    virtual void draw(sf::RenderTarget& target) = 0;
+
+    // 播放方式的名稱（顯示在啟動訊息）
+    virtual const char* getModeName() const = 0;
+
+    virtual std::size_t getFrameCount() const = 0;
+
+    // 已解碼的幀數
+    virtual std::size_t getDecodedCount() const = 0;
+
+    // 需要解碼 PNG 的幀數（資源包沒有或內容已改變）
+    virtual std::size_t getPackMissCount() const = 0;
+
+    // 到時間時還沒準備好的幀數
+    virtual std::size_t getLateFrameCount() const {
+        return 0;
+    }
+
+    // 沒有顯示就被跳過的幀數
+    virtual std::size_t getDroppedFrameCount() const {
+        return 0;
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "asset_loader.hpp"
+#include "asset_pack.hpp"
+#include "atlas_background.hpp"
+#include "background_animation.hpp"
+#include "shader_background.hpp"
+#include "streaming_background.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 背景動畫的播放方式
+struct BackgroundOptions {
+    std::uint64_t preloadBudget = 128ull << 20;  // 整段解碼後（RGBA）不超過這個大小時預先載入，否則串流解碼
+    std::size_t streamDepth = 4;                 // 串流解碼同時存在的幀數
+    bool stream = false;                         // 一律串流解碼
+    bool shader = false;                         // 預先載入時以 shader 選幀
+};
+
+// 依動畫大小選擇播放方式：放得進預算的動畫只解碼一次並預先載入（圖集，或要求時以 shader 選幀，
+// 不支援時改用圖集）；超過預算（以第一幀的大小估計）或無法讀取大小時串流解碼。
+// pack 必須比背景活得久；必須在有 OpenGL context 的執行緒呼叫
+inline std::unique_ptr<BackgroundAnimation> createBackgroundAnimation(const std::vector<std::string>& framePaths,
+                                                                      float frameDuration, const sf::Vector2f& size,
+                                                                      const AssetPack* pack,
+                                                                      const BackgroundOptions& options) {
+    sf::Vector2u frameSize;
+    const bool preload = !options.stream && !framePaths.empty() && readPngSize(framePaths[0], frameSize) &&
+                         static_cast<std::uint64_t>(frameSize.x) * frameSize.y * 4 * framePaths.size() <=
+                             options.preloadBudget;
+    if (preload) {
+        if (options.shader) {
+            std::unique_ptr<ShaderBackground> background(new ShaderBackground());
+            if (background->create(framePaths, frameDuration, size, pack)) {
+                return background;
+            }
+        }
+        return std::unique_ptr<BackgroundAnimation>(new AtlasBackground(framePaths, frameDuration, size, pack));
+    }
+    return std::unique_ptr<BackgroundAnimation>(
+        new StreamingBackground(framePaths, frameDuration, size, options.streamDepth, pack));
+}
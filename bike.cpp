@@ -6,417 +6,972 @@
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include "asset_loader.hpp"
+#include "asset_resolver.hpp"
+#include "entity_store.hpp"
+#include "event_scheduler.hpp"
+#include "fixed_timestep.hpp"
+#include "hud_text.hpp"
+#include "game_random.hpp"
+#include "input_recording.hpp"
+#include "level_data.hpp"
+#include "render_layer.hpp"
+#include "scene_stack.hpp"
+#include "shape_sprites.hpp"
+#include "spatial_grid.hpp"
+#include "sprite_batch.hpp"
+#include "tick_input.hpp"
 
 // 常量定義
 const int windowWidth = 1200;
 const int windowHeight = 800;
 const int maxPlayerHealth = 5000;
-const int maxEnemyHealth = 500;
-const int maxBossMultiplier = 5; // BOSS 血量是普通怪物的 5 倍
-const int maxActiveEnemies = 5;  // 每次最多存在的敵對生物數量
-const float playerBulletSpeed = -0.5f; // 玩家子彈速度
-const float enemyBulletSpeed = 0.3f;   // 敵人子彈速度
+const float playerBulletSpeed = -500.f; // 玩家子彈速度（每秒像素）
+const float enemyBulletSpeed = 300.f;   // 敵人子彈速度（每秒像素）
+const float enemyVolleyInterval = 2.0f; // 敵人每隔幾秒一起發射一次
 const int baseBulletDamage = 250;
-const float baseMoveSpeed = 0.1f;
+const float baseMoveSpeed = 100.f;      // 玩家移動速度（每秒像素）
+const float moveSpeedUpgrade = 50.f;
 
 // 升級選項價格
 const int healthUpgradeCost = 100;
 const int damageUpgradeCost = 200;
 const int speedUpgradeCost = 150;
 
-struct Enemy {
-    sf::CircleShape shape;
-    int health;
-    bool movingRight;
-    bool isBoss;
+// 實體外觀（實體本身以結構陣列存放，繪製時才產生圖形；敵人的大小與顏色見 levels.txt）
+const sf::Vector2f bulletSize(10.f, 20.f);
+const sf::Color playerBulletColor(0, 255, 0); // 綠色
+const sf::Color enemyBulletColor(255, 0, 0);  // 紅色
+const unsigned int enemyShapeDiameter = 128;  // 敵人圓形圖案的解析度，繪製時平滑縮放到原型的大小
+
+// 實體池預先配置的容量，關卡進行中新增子彈與敵人不配置記憶體
+// （敵人池依關卡的同時上限配置）
+const std::size_t playerBulletPoolCapacity = 32;
+const std::size_t enemyBulletPoolCapacity = 64;
+
+// 玩家方塊
+const sf::Vector2f playerSize(100.f, 100.f);
+const sf::Color playerColor(255, 0, 0);
+const float playAreaLeft = 200.f;                 // 左邊界
+const float playAreaRight = windowWidth - 200.f;  // 右邊界
+
+// 無頭模式
+const unsigned int headlessSeed = 12345;          // 固定亂數種子
+const unsigned long headlessDefaultTicks = 120000;
+
+// 跨關卡保留的狀態（商店升級也改這裡）
+struct CampaignState {
+    int playerHealth = maxPlayerHealth;
+    int bulletDamage = baseBulletDamage;
+    float moveSpeed = baseMoveSpeed;
+    int gold = 30000;
+    float playerBulletTimer = 0.0f;  // 射擊計時器（跨關卡保留）
+    std::uint64_t tick = 0;          // 關卡中經過的 tick 數（跨關卡累計），關卡的排程器從這裡開始
+    std::uint64_t nextVolleyTick = ticksFromSeconds(enemyVolleyInterval, SIMULATION_TICK_RATE);
+};
 
-    bool operator==(const Enemy& other) const {
-        return this == &other; // 比較記憶體地址，確認是同一實例
+// 購買商店升級，金幣不足時回傳 false；商店畫面與重播共用
+bool buyUpgrade(int option, CampaignState& campaign) {
+    if (option == 0 && campaign.gold >= healthUpgradeCost) {
+        campaign.playerHealth += 1000;
+        campaign.gold -= healthUpgradeCost;
+    } else if (option == 1 && campaign.gold >= damageUpgradeCost) {
+        campaign.bulletDamage += 50;
+        campaign.gold -= damageUpgradeCost;
+    } else if (option == 2 && campaign.gold >= speedUpgradeCost) {
+        campaign.moveSpeed += moveSpeedUpgrade;
+        campaign.gold -= speedUpgradeCost;
+    } else {
+        return false;
     }
+    return true;
+}
+
+// 關卡的定時事件
+enum LevelEvent : std::uint8_t {
+    LEVEL_EVENT_SPAWN,         // 生成下一個敵人
+    LEVEL_EVENT_ENEMY_VOLLEY,  // 所有敵人一起發射
 };
 
-// 暫停功能
-void showPauseScreen(sf::RenderWindow& window, sf::Font& font) {
-    sf::Text pauseText("Game Paused", font, 50);
-    pauseText.setFillColor(sf::Color::Blue);
-    pauseText.setPosition(windowWidth / 2 - 150, windowHeight / 2 - 50);
-
-    sf::Text instructionText("Press P to Resume", font, 30);
-    instructionText.setFillColor(sf::Color::Black);
-    instructionText.setPosition(windowWidth / 2 - 150, windowHeight / 2 + 50);
-
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-                return;
+// 單一關卡的模擬：生成、移動、碰撞與計分。不依賴視窗與鍵盤，
+// 每個 tick 只讀取 TickInput，因此也能在沒有顯示器的環境執行（--headless）
+class LevelSimulation {
+private:
+    const LevelDefinition definition;
+    CampaignState& state;
+    GameRandom& random;     // 跨關卡共用，整場遊戲由種子決定
+    SpatialGrid enemyGrid;  // 敵人碰撞網格，涵蓋左右邊界之間的遊戲區域
+    int spawnedEnemies = 0;
+    std::size_t waveIndex = 0;        // 目前生成中的波次
+    std::uint32_t spawnedInWave = 0;
+    bool bossSpawned = false;
+    bool spawnScheduled = false;
+    EntityHandle bossHandle;  // 以穩定代號追蹤 BOSS，不受陣列搬移影響
+    EventScheduler<LevelEvent> events;  // 時間與 state.tick 相同
+
+    // 還有敵人要生成，且同時存在的數量未達上限（空的波次直接跳過）
+    bool canSpawn() {
+        while (waveIndex < definition.waves.size() && spawnedInWave >= definition.waves[waveIndex].count) {
+            ++waveIndex;
+            spawnedInWave = 0;
+        }
+        return waveIndex < definition.waves.size() && enemies.size() < definition.maxActive;
+    }
+
+    // 在下一個 tick 生成；每個 tick 最多生成一個敵人
+    void scheduleSpawn(std::uint64_t delay = 1) {
+        if (!spawnScheduled) {
+            events.schedule(delay, LEVEL_EVENT_SPAWN);
+            spawnScheduled = true;
+        }
+    }
+
+    void spawnEnemy() {
+        const std::uint8_t kind = definition.waves[waveIndex].archetype;
+        const EnemyArchetype& archetype = definition.archetypes[kind];
+        float spawnX = playAreaLeft + random.nextInt(static_cast<int>(playAreaRight - playAreaLeft));
+        float direction = random.nextInt(2) == 0 ? 1.f : -1.f;
+        enemies.add(spawnX, 50, archetype.radius * 2, archetype.radius * 2, direction * archetype.speed, 0.f,
+                    archetype.health, 0, kind);
+        ++spawnedEnemies;
+        ++spawnedInWave;
+
+        // 生成 BOSS
+        if (definition.hasBoss && !bossSpawned && spawnedEnemies >= static_cast<int>(definition.bossAfterSpawned)) {
+            const EnemyArchetype& boss = definition.archetypes[definition.bossArchetype];
+            bossHandle = enemies.add(windowWidth / 2 - boss.radius, 50, boss.radius * 2, boss.radius * 2, boss.speed, 0.f,
+                                     boss.health, ENTITY_BOSS, definition.bossArchetype);
+            bossSpawned = true;
+        }
+    }
+
+    void handleEvent(LevelEvent event) {
+        switch (event) {
+        case LEVEL_EVENT_SPAWN:
+            // 空位不足時不再排程，等有敵人被擊敗時再排
+            spawnScheduled = false;
+            if (canSpawn()) {
+                spawnEnemy();
+            }
+            if (canSpawn()) {
+                scheduleSpawn();
             }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::P)) {
-                return; // 按下 P 鍵繼續遊戲
+            break;
+        case LEVEL_EVENT_ENEMY_VOLLEY:
+            for (size_t i = 0; i < enemies.size(); ++i) {
+                float radius = enemies.width[i] / 2;
+                enemyBullets.add(enemies.x[i] + radius - 5, enemies.y[i] + radius * 2,
+                                 bulletSize.x, bulletSize.y, 0.f, enemyBulletSpeed);
             }
+            state.nextVolleyTick = events.getTick() + ticksFromSeconds(enemyVolleyInterval, SIMULATION_TICK_RATE);
+            events.scheduleAt(state.nextVolleyTick, LEVEL_EVENT_ENEMY_VOLLEY);
+            break;
         }
+    }
 
-        window.clear(sf::Color::White);
-        window.draw(pauseText);
-        window.draw(instructionText);
-        window.display();
+public:
+    const float playerBulletCooldown = 0.4f;
+
+    EntityStore playerBullets;
+    EntityStore enemyBullets;
+    EntityStore enemies;
+    sf::Vector2f playerPosition;          // 玩家方塊左上角
+    sf::Vector2f previousPlayerPosition;  // 上一個 tick 的位置，用於插值繪製
+    int defeatedEnemies = 0;
+    int enemiesToSpawn;
+
+    LevelSimulation(const LevelDefinition& level, CampaignState& campaign, GameRandom& gameRandom)
+        : definition(level), state(campaign), random(gameRandom),
+          enemyGrid(playAreaLeft, 0, playAreaRight - playAreaLeft, windowHeight, 128), events(campaign.tick),
+          playerPosition(windowWidth / 2 - 50, windowHeight - 150),
+          previousPlayerPosition(playerPosition),
+          enemiesToSpawn(level.getEnemyCount()) {
+        playerBullets.reserve(playerBulletPoolCapacity);
+        enemyBullets.reserve(enemyBulletPoolCapacity);
+        enemies.reserve(level.maxActive + (level.hasBoss ? 1 : 0));
+        // 齊射的間隔跨關卡延續
+        events.scheduleAt(state.nextVolleyTick, LEVEL_EVENT_ENEMY_VOLLEY);
+        if (canSpawn()) {
+            scheduleSpawn(0);
+        }
     }
-}
 
-// 顯示等待頁面與商店選單
-void showShop(sf::RenderWindow& window, sf::Font& font, int& gold, int& playerHealth, int& bulletDamage, float& moveSpeed) {
-    sf::Text shopTitle("Shop - Spend your Gold", font, 50);
-    shopTitle.setFillColor(sf::Color::Blue);
-    shopTitle.setPosition(windowWidth / 2 - 250, 100);
+    const LevelDefinition& getDefinition() const {
+        return definition;
+    }
 
-    sf::Text instruction("Press Space to Confirm, Up/Down to Navigate", font, 20);
-    instruction.setFillColor(sf::Color::Black);
-    instruction.setPosition(windowWidth / 2 - 250, 170);
+    // 關卡開始後實體池因容量不足而配置記憶體的次數
+    std::size_t getAllocationCount() const {
+        return playerBullets.getAllocationCount() + enemyBullets.getAllocationCount() + enemies.getAllocationCount();
+    }
 
-    std::vector<std::string> options = {
-        "Increase Health (+1000) - Cost: 100",
-        "Increase Bullet Damage (+50) - Cost: 200",
-        "Increase Move Speed (+0.05) - Cost: 150",
-        "Exit Shop"
-    };
+    bool isCleared() const {
+        return defeatedEnemies >= enemiesToSpawn;
+    }
 
-    int selectedOption = 0;
+    bool isFinished() const {
+        return isCleared() || state.playerHealth <= 0;
+    }
 
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-                return;
-            }
-            if (event.type == sf::Event::KeyPressed) {
-                if (event.key.code == sf::Keyboard::Up) {
-                    selectedOption = (selectedOption - 1 + options.size()) % options.size();
-                } else if (event.key.code == sf::Keyboard::Down) {
-                    selectedOption = (selectedOption + 1) % options.size();
-                } else if (event.key.code == sf::Keyboard::Space) {
-                    if (selectedOption == 0 && gold >= healthUpgradeCost) {
-                        playerHealth += 1000;
-                        gold -= healthUpgradeCost;
-                    } else if (selectedOption == 1 && gold >= damageUpgradeCost) {
-                        bulletDamage += 50;
-                        gold -= damageUpgradeCost;
-                    } else if (selectedOption == 2 && gold >= speedUpgradeCost) {
-                        moveSpeed += 0.05f;
-                        gold -= speedUpgradeCost;
-                    } else if (selectedOption == 3) {
-                        return; // 退出商店
-                    }
-                }
+    bool isBossAlive() const {
+        return bossSpawned && enemies.isAlive(bossHandle);
+    }
+
+    sf::FloatRect getPlayerBounds() const {
+        return sf::FloatRect(playerPosition, playerSize);
+    }
+
+    // 關卡與跨關卡狀態的雜湊，用來確認重播與錄製的結果完全相同
+    std::uint64_t getStateHash() const {
+        std::uint64_t hash = enemies.hashState(playerBullets.hashState(enemyBullets.hashState()));
+        hash = events.hashState(hash);
+        const float values[] = {playerPosition.x, playerPosition.y, state.moveSpeed, state.playerBulletTimer};
+        const int counters[] = {state.playerHealth, state.bulletDamage, state.gold, spawnedEnemies, defeatedEnemies};
+        hash = hashBytes(values, sizeof(values), hash);
+        return hashBytes(counters, sizeof(counters), hash);
+    }
+
+    // 單一 tick 的遊戲邏輯
+    void tick(float dt, const TickInput& input) {
+        if (isFinished()) {
+            return;
+        }
+
+        // 玩家移動
+        previousPlayerPosition = playerPosition;
+        if (input.isDown(INPUT_LEFT) && playerPosition.x > playAreaLeft) {
+            playerPosition.x -= state.moveSpeed * dt;
+        }
+        if (input.isDown(INPUT_RIGHT) && playerPosition.x < playAreaRight - playerSize.x) {
+            playerPosition.x += state.moveSpeed * dt;
+        }
+
+        // 玩家子彈發射
+        state.playerBulletTimer += dt;
+        if (input.isDown(INPUT_FIRE) && state.playerBulletTimer >= playerBulletCooldown) {
+            playerBullets.add(playerPosition.x + playerSize.x / 2 - 5, playerPosition.y,
+                              bulletSize.x, bulletSize.y, 0.f, playerBulletSpeed);
+            state.playerBulletTimer = 0.0f;
+        }
+
+        playerBullets.integrate(dt);
+
+        // 觸發這個 tick 到期的事件（敵人生成、敵人齊射）
+        events.advance([this](LevelEvent event) { handleEvent(event); });
+        state.tick = events.getTick();
+
+        // 敵人左右移動，碰到邊界折返
+        enemies.integrate(dt);
+        for (size_t i = 0; i < enemies.size(); ++i) {
+            if (enemies.velocityX[i] > 0 && enemies.x[i] + enemies.width[i] >= playAreaRight) {
+                enemies.velocityX[i] = -enemies.velocityX[i];
+            } else if (enemies.velocityX[i] < 0 && enemies.x[i] <= playAreaLeft) {
+                enemies.velocityX[i] = -enemies.velocityX[i];
             }
         }
 
-        // 顯示商店選單
-        window.clear(sf::Color::White);
-        window.draw(shopTitle);
-        window.draw(instruction);
+        enemyBullets.integrate(dt);
 
-        for (size_t i = 0; i < options.size(); ++i) {
-            sf::Text optionText(options[i], font, 30);
-            optionText.setFillColor(i == selectedOption ? sf::Color::Red : sf::Color::Black);
-            optionText.setPosition(windowWidth / 2 - 300, 250 + i * 50);
-            window.draw(optionText);
+        // 碰撞檢測（先以網格篩選，再逐一比對 AABB）
+        enemyGrid.build(enemies);
+        for (size_t bulletIndex = 0; bulletIndex < playerBullets.size(); ++bulletIndex) {
+            long enemyIndex = enemyGrid.findFirstOverlap(playerBullets, bulletIndex, enemies);
+            if (enemyIndex < 0) {
+                continue;
+            }
+            enemies.health[enemyIndex] -= state.bulletDamage;
+            if (enemies.health[enemyIndex] <= 0) {
+                enemies.kill(enemyIndex);
+                ++defeatedEnemies;
+                state.gold += 50;
+                if (waveIndex < definition.waves.size()) {
+                    scheduleSpawn();  // 空出位置，下一個 tick 補上
+                }
+            }
+            playerBullets.kill(bulletIndex);
         }
 
-        sf::Text goldText("Current Gold: " + std::to_string(gold), font, 30);
-        goldText.setFillColor(sf::Color::Black);
-        goldText.setPosition(windowWidth / 2 - 300, 450);
-        window.draw(goldText);
+        // 玩家碰撞框一次比對 8 顆敵人子彈
+        forEachEntityOverlapping(enemyBullets, getPlayerBounds(), [&](size_t bulletIndex) {
+            state.playerHealth -= 200;
+            enemyBullets.kill(bulletIndex);
+            return true;
+        });
+
+        // 離開畫面的子彈不可能再擊中任何東西，回收到實體池
+        for (size_t bulletIndex = 0; bulletIndex < playerBullets.size(); ++bulletIndex) {
+            if (playerBullets.y[bulletIndex] + playerBullets.height[bulletIndex] < 0) {
+                playerBullets.kill(bulletIndex);
+            }
+        }
+        for (size_t bulletIndex = 0; bulletIndex < enemyBullets.size(); ++bulletIndex) {
+            if (enemyBullets.y[bulletIndex] > windowHeight) {
+                enemyBullets.kill(bulletIndex);
+            }
+        }
 
-        window.display();
+        // tick 結束時統一移除被標記刪除的實體
+        playerBullets.compact();
+        enemyBullets.compact();
+        enemies.compact();
     }
+};
+
+// 比對重播結束時的狀態與錄製時是否相同
+bool reportReplayResult(const InputRecording& recording, std::uint64_t stateHash) {
+    const bool matches = stateHash == recording.finalStateHash;
+    std::cout << "Replay of " << recording.tickCount << " ticks finished: "
+              << (matches ? "state matches recording" : "STATE DIVERGED from recording") << std::endl;
+    return matches;
 }
 
-// 顯示關卡畫面
-void showLevelScreen(sf::RenderWindow& window, sf::Font& font, const std::string& message, int& gold, int& playerHealth) {
-    sf::Text levelText(message, font, 50);
-    levelText.setFillColor(sf::Color::Blue);
-    levelText.setPosition(windowWidth / 2 - 250, windowHeight / 2 - 50);
-
-    sf::Text goldText("Gold: " + std::to_string(gold), font, 30);
-    goldText.setFillColor(sf::Color::Black);
-    goldText.setPosition(windowWidth / 2 - 200, windowHeight / 2 + 50);
-
-    sf::Text healthText("Player Health: " + std::to_string(playerHealth), font, 30);
-    healthText.setFillColor(sf::Color::Black);
-    healthText.setPosition(windowWidth / 2 - 200, windowHeight / 2 + 100);
-
-    sf::Text instructionText("Press Space to Continue", font, 30);
-    instructionText.setFillColor(sf::Color::Black);
-    instructionText.setPosition(windowWidth / 2 - 200, windowHeight / 2 + 150);
-
-    while (window.isOpen()) {
-        sf::Event event;
-        while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-                return;
+// --headless：不開視窗，以腳本輸入連續打完所有關卡（略過商店與關卡畫面）並回報速度；
+// 玩家死亡或通關後從第一關重新開始。
+// 指定 replayPath 時改用錄製的種子、輸入與商店購買，tick 數與錄製相同
+int runHeadless(const LevelLibrary& library, unsigned long tickCount, const std::string& script,
+                const std::string& recordPath, const std::string& replayPath) {
+    InputReplay replay;
+    const bool replaying = !replayPath.empty();
+    std::uint32_t seed = headlessSeed;  // 固定種子，每次執行的敵人生成相同
+    if (replaying) {
+        if (!replay.load(replayPath)) {
+            std::cerr << "Error: Could not load input recording " << replayPath << std::endl;
+            return 1;
+        }
+        seed = replay.getRecording().seed;
+        tickCount = static_cast<unsigned long>(replay.getRecording().tickCount);
+    }
+    const bool recording = !recordPath.empty();
+    GameRandom random(seed);
+    ScriptedInput input(script);
+    InputRecorder recorder(seed, SIMULATION_TICK_RATE);
+    const float step = 1.f / SIMULATION_TICK_RATE;
+
+    CampaignState campaign;
+    const int lastLevel = static_cast<int>(library.getLevelCount());
+    int currentLevel = 1;
+    LevelDefinition definition;
+    if (!library.load(currentLevel, definition)) {
+        std::cerr << "Error: Could not load level " << currentLevel << std::endl;
+        return 1;
+    }
+    std::unique_ptr<LevelSimulation> level(new LevelSimulation(definition, campaign, random));
+    unsigned long levelsCleared = 0, deaths = 0;
+    std::size_t poolAllocations = 0;  // 各關卡開始後實體池的配置次數
+    std::uint64_t stateHash = 0;
+
+    sf::Clock clock;
+    for (unsigned long i = 0; i < tickCount; ++i) {
+        TickInput tickInput;
+        if (replaying) {
+            replay.nextTick(tickInput);
+        } else {
+            tickInput = input.next();
+            if (recording) {
+                recorder.recordTick(tickInput);
             }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
-                return;
+        }
+        level->tick(step, tickInput);
+        if (replaying || recording) {
+            stateHash = level->getStateHash();
+        }
+        if (!level->isFinished()) {
+            continue;
+        }
+        poolAllocations += level->getAllocationCount();
+        if (level->isCleared()) {
+            ++levelsCleared;
+        } else {
+            ++deaths;
+        }
+        if (level->isCleared() && currentLevel < lastLevel) {
+            ++currentLevel;
+            // 錄製時在商店買的升級
+            std::uint8_t option;
+            while (replaying && replay.nextUpgrade(option)) {
+                buyUpgrade(option, campaign);
             }
+        } else {
+            campaign = CampaignState();
+            currentLevel = 1;
+        }
+        if (!library.load(currentLevel, definition)) {
+            std::cerr << "Error: Could not load level " << currentLevel << std::endl;
+            return 1;
         }
+        level.reset(new LevelSimulation(definition, campaign, random));
+    }
+    const float seconds = clock.getElapsedTime().asSeconds();
+
+    std::cout << "Headless: " << tickCount << " ticks (" << tickCount * step << " s simulated) in "
+              << seconds * 1000.f << " ms, " << (seconds > 0.f ? tickCount / seconds : 0.f) << " ticks/s" << std::endl;
+    std::cout << "levels cleared: " << levelsCleared << "  deaths: " << deaths << "  current level: " << currentLevel
+              << "  gold: " << campaign.gold << std::endl;
+    std::cout << "entity pool allocations after reserve: " << poolAllocations + level->getAllocationCount() << std::endl;
 
-        window.clear(sf::Color::White);
-        window.draw(levelText);
-        window.draw(goldText);
-        window.draw(healthText);
-        window.draw(instructionText);
-        window.display();
+    if (replaying) {
+        return reportReplayResult(replay.getRecording(), stateHash) ? 0 : 1;
+    }
+    if (recording && !recorder.save(recordPath, stateHash)) {
+        std::cerr << "Error: Could not write input recording " << recordPath << std::endl;
+        return 1;
     }
+    return 0;
 }
 
-int main() {
-    // 初始化隨機數
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
+// 暫停畫面：按 P 回到遊戲
+class PauseScene : public Scene {
+private:
+    SceneStack& scenes;
+    sf::Text pauseText;
+    sf::Text instructionText;
+
+public:
+    PauseScene(SceneStack& sceneStack, const sf::Font& font)
+        : scenes(sceneStack), pauseText("Game Paused", font, 50), instructionText("Press P to Resume", font, 30) {
+        pauseText.setFillColor(sf::Color::Blue);
+        pauseText.setPosition(windowWidth / 2 - 150, windowHeight / 2 - 50);
+        instructionText.setFillColor(sf::Color::Black);
+        instructionText.setPosition(windowWidth / 2 - 150, windowHeight / 2 + 50);
+    }
 
-    // 創建視窗
-    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight), "Square vs Enemies");
+    void handleEvent(const sf::Event& event) override {
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+            scenes.pop(); // 按下 P 鍵繼續遊戲
+        }
+    }
 
-    // 字體
-    sf::Font font;
-    if (!font.loadFromFile("arial.ttf")) {
-        std::cerr << "Error: Could not load font!" << std::endl;
-        return -1;
+    void draw(sf::RenderTarget& target) override {
+        target.clear(sf::Color::White);
+        target.draw(pauseText);
+        target.draw(instructionText);
     }
+};
 
-    // 初始數據
-    int playerHealth = maxPlayerHealth;
-    int bulletDamage = baseBulletDamage;
-    float moveSpeed = baseMoveSpeed;
-    int gold = 30000;
+// 商店選單，選擇 Exit Shop 時呼叫 onExit
+// recorder 不為空時記錄每一筆購買，重播時不顯示商店而直接套用
+class ShopScene : public Scene {
+private:
+    static const int EXIT_OPTION = 3;
+
+    CampaignState& campaign;
+    InputRecorder* recorder;
+    std::function<void()> onExit;
+    HudLayer shopText;  // 所有文字只建立一次，之後只在選項或金幣改變時重建
+    std::vector<HudText*> optionTexts;
+    HudText* goldText;
+    int selectedOption = 0;
 
-    // 初始化文字
-    sf::Text goldText("Gold: 0", font, 20);
-    goldText.setFillColor(sf::Color::Black);
-    goldText.setPosition(20, 80);
+    // 選項或金幣改變
+    void refresh() {
+        for (size_t i = 0; i < optionTexts.size(); ++i) {
+            optionTexts[i]->setColor(static_cast<int>(i) == selectedOption ? sf::Color::Red : sf::Color::Black);
+        }
+        goldText->setValues(campaign.gold);
+        invalidate();
+    }
 
-    sf::Text playerHealthText("Health: " + std::to_string(playerHealth) + "/" + std::to_string(maxPlayerHealth), font, 20);
-    playerHealthText.setFillColor(sf::Color::Black);
-    playerHealthText.setPosition(20, 50);
+public:
+    ShopScene(const sf::Font& font, CampaignState& campaignState, InputRecorder* inputRecorder,
+              std::function<void()> exitAction)
+        : campaign(campaignState), recorder(inputRecorder), onExit(std::move(exitAction)) {
+        shopText.add(font, 50, sf::Vector2f(windowWidth / 2 - 250, 100), sf::Color::Blue, "Shop - Spend your Gold");
+        shopText.add(font, 20, sf::Vector2f(windowWidth / 2 - 250, 170), sf::Color::Black,
+                     "Press Space to Confirm, Up/Down to Navigate");
+
+        const char* const options[] = {
+            "Increase Health (+1000) - Cost: 100",
+            "Increase Bullet Damage (+50) - Cost: 200",
+            "Increase Move Speed (+50) - Cost: 150",
+            "Exit Shop"
+        };
+        for (size_t i = 0; i < 4; ++i) {
+            optionTexts.push_back(&shopText.add(font, 30, sf::Vector2f(windowWidth / 2 - 300, 250 + i * 50), sf::Color::Black, options[i]));
+        }
+        goldText = &shopText.add(font, 30, sf::Vector2f(windowWidth / 2 - 300, 450), sf::Color::Black);
+        goldText->setPattern("Current Gold: %ld");
+        refresh();
+    }
 
-    sf::Text bossNameText("", font, 30);
-    bossNameText.setFillColor(sf::Color::Magenta);
-    bossNameText.setPosition(windowWidth / 2 - 150, 10);
+    void handleEvent(const sf::Event& event) override {
+        if (event.type != sf::Event::KeyPressed) {
+            return;
+        }
+        const int optionCount = static_cast<int>(optionTexts.size());
+        if (event.key.code == sf::Keyboard::Up) {
+            selectedOption = (selectedOption - 1 + optionCount) % optionCount;
+        } else if (event.key.code == sf::Keyboard::Down) {
+            selectedOption = (selectedOption + 1) % optionCount;
+        } else if (event.key.code == sf::Keyboard::Space) {
+            if (selectedOption == EXIT_OPTION) {
+                onExit(); // 退出商店
+                return;
+            }
+            if (buyUpgrade(selectedOption, campaign) && recorder) {
+                recorder->recordUpgrade(static_cast<std::uint8_t>(selectedOption));
+            }
+        } else {
+            return;
+        }
+        refresh();
+    }
 
-    // BOSS 名稱
-    std::vector<std::string> bossNames = {"rrro", "IM_Head", "syua_yuan_a_pei"};
+    void draw(sf::RenderTarget& target) override {
+        target.clear(sf::Color::White);
+        target.draw(shopText);
+    }
+};
 
-    // 顯示遊戲開始畫面
-    showLevelScreen(window, font, "Welcome to Square vs Enemies!", gold, playerHealth);
+// 關卡畫面（開始、過關與結束），按 Space 時呼叫 onContinue
+class MessageScene : public Scene {
+private:
+    sf::Text levelText;
+    sf::Text goldText;
+    sf::Text healthText;
+    sf::Text instructionText;
+    std::function<void()> onContinue;
+
+public:
+    MessageScene(const sf::Font& font, const std::string& message, int gold, int playerHealth,
+                 std::function<void()> continueAction)
+        : levelText(message, font, 50), goldText("Gold: " + std::to_string(gold), font, 30),
+          healthText("Player Health: " + std::to_string(playerHealth), font, 30),
+          instructionText("Press Space to Continue", font, 30), onContinue(std::move(continueAction)) {
+        levelText.setFillColor(sf::Color::Blue);
+        levelText.setPosition(windowWidth / 2 - 250, windowHeight / 2 - 50);
+        goldText.setFillColor(sf::Color::Black);
+        goldText.setPosition(windowWidth / 2 - 200, windowHeight / 2 + 50);
+        healthText.setFillColor(sf::Color::Black);
+        healthText.setPosition(windowWidth / 2 - 200, windowHeight / 2 + 100);
+        instructionText.setFillColor(sf::Color::Black);
+        instructionText.setPosition(windowWidth / 2 - 200, windowHeight / 2 + 150);
+    }
 
-    // 主遊戲循環
-    int currentLevel = 1;
-    while (currentLevel <= 3 && window.isOpen()) {
-        // 顯示關卡開始畫面
-        showLevelScreen(window, font, "Level " + std::to_string(currentLevel) + " Starting...", gold, playerHealth);
-
-        // 初始化關卡相關數據
-        std::vector<sf::RectangleShape> playerBullets;
-        std::vector<sf::RectangleShape> enemyBullets;
-        std::vector<Enemy> enemies;
-        int spawnedEnemies = 0, defeatedEnemies = 0;
-        bool bossSpawned = false;
-        int enemiesToSpawn = currentLevel == 1 ? 15 : (currentLevel == 2 ? 20 : 25);
-        sf::Clock clock;
-
-        sf::RectangleShape square(sf::Vector2f(100, 100));
-        square.setFillColor(sf::Color::Red);
-        square.setPosition(windowWidth / 2 - 50, windowHeight - 150);
-
-        sf::RectangleShape leftBoundary(sf::Vector2f(5, windowHeight));
-        leftBoundary.setFillColor(sf::Color::Black);
-        leftBoundary.setPosition(200, 0);
+    void handleEvent(const sf::Event& event) override {
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Space) {
+            onContinue();
+        }
+    }
 
-        sf::RectangleShape rightBoundary(sf::Vector2f(5, windowHeight));
-        rightBoundary.setFillColor(sf::Color::Black);
-        rightBoundary.setPosition(windowWidth - 200, 0);
+    void draw(sf::RenderTarget& target) override {
+        target.clear(sf::Color::White);
+        target.draw(levelText);
+        target.draw(goldText);
+        target.draw(healthText);
+        target.draw(instructionText);
+    }
+};
 
-        sf::RectangleShape playerHealthBar(sf::Vector2f(300, 20));
-        playerHealthBar.setFillColor(sf::Color::Green);
-        playerHealthBar.setPosition(20, 20);
+// 遊戲進行中的畫面：依序進行每一關，關卡畫面、商店與暫停畫面推到它上面。
+// 重播時使用錄製的種子，並略過需要按鍵的關卡畫面與商店
+class PlayScene : public Scene {
+private:
+    SceneStack& scenes;
+    sf::Font& font;
+    const AssetResolver& assets;
+    const LevelLibrary& library;
+    GameRandom& random;
+    InputReplay& replay;
+    bool replaying;
+    std::unique_ptr<InputRecorder> recorder;
+    std::string recordPath;
+    std::uint64_t stateHash = 0;  // 最後一個 tick 結束時的狀態雜湊
+    int exitCode = 0;
+
+    CampaignState campaign;
+    const int lastLevel;
+    int currentLevel = 1;
+    LevelDefinition definition;  // 下一個開始的關卡（目前關卡的資料在 LevelSimulation 內）
+    std::unique_ptr<LevelSimulation> level;
+
+    // 固定步長排程器，與 test.cpp 共用
+    FixedTimestep timestep{SIMULATION_TICK_RATE};
+
+    // 初始化文字：HUD 文字合併繪製，數值改變時才重建
+    HudLayer hud;
+    HudText& goldText;
+    HudText& playerHealthText;
+    HudText& bossNameText;
+
+    // 玩家、子彈與敵人都是圖集上的方塊（程式產生的圖案），同一個批次繪製
+    TextureAtlas shapeAtlas;
+    const sf::Texture* shapeTexture = nullptr;  // 圖集建立失敗時為空，以純色方塊繪製
+    sf::FloatRect squareTexRect;
+    sf::FloatRect circleTexRect;
+    SpriteBatch entityBatch;
+
+    sf::RectangleShape leftBoundary{sf::Vector2f(5, windowHeight)};
+    sf::RectangleShape rightBoundary{sf::Vector2f(5, windowHeight)};
+    sf::RectangleShape playerHealthBar{sf::Vector2f(300, 20)};
+
+    // 關卡背景（可選）：在背景執行緒解碼，下一關的背景在商店畫面期間就開始解碼
+    AssetLoader backgroundLoader{1};
+    sf::Texture backgroundTexture;
+    sf::Sprite backgroundSprite;
+    bool hasBackground = false;
+
+    // 靜態的圖層只在改變時重畫：背景與邊界每關一次，血條與 HUD 在數值改變時
+    CachedLayer playfieldLayer;
+    CachedLayer hudLayer;
+    int shownHealth = -1;
+    int shownGold = -1;
+    bool shownBoss = false;
+
+    void requestBackground() {
+        if (!definition.background.empty()) {
+            backgroundLoader.request(definition.background, assets.resolve(definition.background));
+        }
+    }
 
-        // 遊戲內循環
-        while (defeatedEnemies < enemiesToSpawn && playerHealth > 0 && window.isOpen()) {
-            sf::Event event;
-            while (window.pollEvent(event)) {
-                if (event.type == sf::Event::Closed) {
-                    window.close();
-                }
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::P)) {
-                    showPauseScreen(window, font); // 暫停遊戲
-                }
+    // 等待已排入的背景解碼完成並上傳（通常在商店期間就已完成，不必等待）
+    void uploadBackground() {
+        hasBackground = false;
+        while (!backgroundLoader.isFinished()) {
+            DecodedImage decoded;
+            if (!backgroundLoader.poll(decoded)) {
+                sf::sleep(sf::milliseconds(1));
+                continue;
             }
-
-            float deltaTime = clock.restart().asSeconds();
-
-            // 玩家移動
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) && square.getPosition().x > 200) {
-                square.move(-moveSpeed, 0);
+            if (!decoded.loaded) {
+                std::cerr << "Error: Could not load level background " << decoded.path << std::endl;
+                continue;
             }
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) && square.getPosition().x < windowWidth - 200 - square.getSize().x) {
-                square.move(moveSpeed, 0);
+            const sf::Vector2u size = decoded.getSize();
+            if (decoded.name == definition.background && backgroundTexture.create(size.x, size.y)) {
+                backgroundTexture.update(decoded.getPixels());
+                backgroundSprite.setTexture(backgroundTexture, true);
+                backgroundSprite.setScale(static_cast<float>(windowWidth) / size.x, static_cast<float>(windowHeight) / size.y);
+                backgroundSprite.setColor(sf::Color(255, 255, 255, definition.backgroundAlpha));
+                hasBackground = true;
             }
+        }
+    }
 
-            // 玩家子彈發射
-            static float playerBulletCooldown = 0.4f;
-            static float playerBulletTimer = 0.0f;
-            playerBulletTimer += deltaTime;
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space) && playerBulletTimer >= playerBulletCooldown) {
-                sf::RectangleShape bullet(sf::Vector2f(10, 20));
-                bullet.setFillColor(sf::Color::Green);
-                bullet.setPosition(square.getPosition().x + square.getSize().x / 2 - 5, square.getPosition().y);
-                playerBullets.push_back(bullet);
-                playerBulletTimer = 0.0f;
-            }
+    // 每一關開始前才從關卡庫讀出該關
+    bool loadLevel(int number) {
+        if (!library.load(number, definition)) {
+            std::cerr << "Error: Could not load level " << number << std::endl;
+            exitCode = 1;
+            scenes.quit();
+            return false;
+        }
+        return true;
+    }
 
-            for (auto& bullet : playerBullets) {
-                bullet.move(0, playerBulletSpeed);
-            }
+    // 開始 definition 這一關，先顯示關卡開始畫面
+    void beginLevel() {
+        if (!replaying) {
+            scenes.push(std::unique_ptr<Scene>(new MessageScene(font, definition.name + " Starting...", campaign.gold,
+                                                                campaign.playerHealth, [this] { scenes.pop(); })));
+        }
+        uploadBackground();
+        level.reset(new LevelSimulation(definition, campaign, random));
+        bossNameText.setString("BOSS: " + definition.bossName);
+        playfieldLayer.invalidate();
+        hudLayer.invalidate();
+        timestep.reset();  // 關卡畫面等待的時間不算進模擬
+    }
 
-            // 敵人生成邏輯
-            if (spawnedEnemies < enemiesToSpawn && enemies.size() < maxActiveEnemies) {
-                Enemy newEnemy;
-                newEnemy.shape = sf::CircleShape(50);
-                newEnemy.shape.setFillColor(sf::Color::Blue);
-                newEnemy.shape.setPosition(200 + std::rand() % (windowWidth - 400), 50);
-                newEnemy.health = maxEnemyHealth;
-                newEnemy.movingRight = std::rand() % 2 == 0;
-                newEnemy.isBoss = false;
-                enemies.push_back(newEnemy);
-                ++spawnedEnemies;
-
-                // 生成 BOSS
-                if (!bossSpawned && spawnedEnemies >= enemiesToSpawn / 2) {
-                    Enemy boss;
-                    boss.shape = sf::CircleShape(70);
-                    boss.shape.setFillColor(sf::Color::Magenta);
-                    boss.shape.setPosition(windowWidth / 2 - 70, 50);
-                    boss.health = maxEnemyHealth * maxBossMultiplier;
-                    boss.movingRight = true;
-                    boss.isBoss = true;
-                    enemies.push_back(boss);
-                    bossNameText.setString("BOSS: " + bossNames[currentLevel - 1]);
-                    bossSpawned = true;
-                }
-            }
+    // 遊戲結束或勝利：顯示結束畫面，按 Space 後離開
+    void endGame(const std::string& message) {
+        finishRecording();
+        scenes.push(std::unique_ptr<Scene>(new MessageScene(font, message, campaign.gold, campaign.playerHealth,
+                                                            [this] { scenes.quit(); })));
+    }
 
-            for (auto& enemy : enemies) {
-                if (enemy.movingRight) {
-                    enemy.shape.move(0.1f, 0);
-                    if (enemy.shape.getPosition().x + enemy.shape.getRadius() * 2 >= windowWidth - 200) {
-                        enemy.movingRight = false;
-                    }
-                } else {
-                    enemy.shape.move(-0.1f, 0);
-                    if (enemy.shape.getPosition().x <= 200) {
-                        enemy.movingRight = true;
-                    }
-                }
+    // 關卡結束後：失敗、全部通關，或進入商店再開始下一關
+    void finishLevel() {
+        if (campaign.playerHealth <= 0) {
+            if (replaying && replay.isFinished()) {
+                finishReplay();
             }
+            endGame("Game Over!");
+            return;
+        }
+        if (currentLevel == lastLevel) {
+            finishReplay();
+            endGame("Victory! Thanks for Playing!");
+            return;
+        }
 
-            // 敵人子彈發射邏輯
-            static float enemyBulletCooldown = 2.0f;
-            static float enemyBulletTimer = 0.0f;
-            enemyBulletTimer += deltaTime;
-            if (enemyBulletTimer >= enemyBulletCooldown) {
-                for (const auto& enemy : enemies) {
-                    sf::RectangleShape bullet(sf::Vector2f(10, 20));
-                    bullet.setFillColor(sf::Color::Red);
-                    bullet.setPosition(enemy.shape.getPosition().x + enemy.shape.getRadius() - 5,
-                                        enemy.shape.getPosition().y + enemy.shape.getRadius() * 2);
-                    enemyBullets.push_back(bullet);
-                }
-                enemyBulletTimer = 0.0f;
-            }
+        // 先讀出下一關並排入背景解碼，與商店畫面同時進行
+        if (!loadLevel(currentLevel + 1)) {
+            return;
+        }
+        requestBackground();
+        ++currentLevel;
 
-            for (auto& bullet : enemyBullets) {
-                bullet.move(0, enemyBulletSpeed);
-            }
+        std::uint8_t option;
+        if (replaying && replay.nextUpgrade(option)) {
+            // 套用錄製時在商店買的升級
+            do {
+                buyUpgrade(option, campaign);
+            } while (replay.nextUpgrade(option));
+        } else if (replaying && replay.isFinished()) {
+            finishReplay();
+        }
+        if (replaying) {
+            beginLevel();
+            return;
+        }
+        scenes.push(std::unique_ptr<Scene>(new ShopScene(font, campaign, recorder.get(), [this] {
+            scenes.pop();
+            beginLevel();
+        })));
+    }
 
-            // 碰撞檢測
-            for (auto it = playerBullets.begin(); it != playerBullets.end();) {
-                bool bulletHit = false;
-                for (auto& enemy : enemies) {
-                    if (it->getGlobalBounds().intersects(enemy.shape.getGlobalBounds())) {
-                        enemy.health -= bulletDamage;
-                        if (enemy.health <= 0) {
-                            if (enemy.isBoss) {
-                                bossNameText.setString("");
-                            }
-                            enemies.erase(std::remove(enemies.begin(), enemies.end(), enemy), enemies.end());
-                            ++defeatedEnemies;
-                            gold += 50;
-                        }
-                        bulletHit = true;
-                        break;
-                    }
-                }
-                if (bulletHit) {
-                    it = playerBullets.erase(it);
-                } else {
-                    ++it;
-                }
-            }
+public:
+    PlayScene(SceneStack& sceneStack, sf::Font& hudFont, const AssetResolver& assetResolver,
+              const LevelLibrary& levelLibrary, GameRandom& gameRandom, InputReplay& inputReplay, bool isReplaying,
+              std::unique_ptr<InputRecorder> inputRecorder, const std::string& recordFile)
+        : scenes(sceneStack), font(hudFont), assets(assetResolver), library(levelLibrary), random(gameRandom),
+          replay(inputReplay), replaying(isReplaying), recorder(std::move(inputRecorder)), recordPath(recordFile),
+          lastLevel(static_cast<int>(levelLibrary.getLevelCount())),
+          goldText(hud.add(hudFont, 20, sf::Vector2f(20, 80), sf::Color::Black)),
+          playerHealthText(hud.add(hudFont, 20, sf::Vector2f(20, 50), sf::Color::Black)),
+          bossNameText(hud.add(hudFont, 30, sf::Vector2f(windowWidth / 2 - 150, 10), sf::Color::Magenta)) {
+        goldText.setPattern("Gold: %ld");
+        playerHealthText.setPattern("Health: %ld/%ld");
+
+        addShapeSprites(shapeAtlas, enemyShapeDiameter);
+        shapeAtlas.setSmooth(true);
+        if (shapeAtlas.build()) {
+            shapeTexture = shapeAtlas.getRegion(SHAPE_SQUARE).texture;
+            squareTexRect = getShapeTexRect(shapeAtlas, SHAPE_SQUARE);
+            circleTexRect = getShapeTexRect(shapeAtlas, SHAPE_CIRCLE);
+        }
+        leftBoundary.setFillColor(sf::Color::Black);
+        leftBoundary.setPosition(playAreaLeft, 0);
+        rightBoundary.setFillColor(sf::Color::Black);
+        rightBoundary.setPosition(playAreaRight, 0);
+        playerHealthBar.setFillColor(sf::Color::Green);
+        playerHealthBar.setPosition(20, 20);
 
-            for (auto it = enemyBullets.begin(); it != enemyBullets.end();) {
-                if (it->getGlobalBounds().intersects(square.getGlobalBounds())) {
-                    playerHealth -= 200;
-                    it = enemyBullets.erase(it);
-                } else {
-                    ++it;
-                }
+        playfieldLayer.create(windowWidth, windowHeight, [this](sf::RenderTarget& target) {
+            if (hasBackground) {
+                target.draw(backgroundSprite);
             }
+            target.draw(leftBoundary);
+            target.draw(rightBoundary);
+        }, sf::Color::White);
+        hudLayer.create(windowWidth, windowHeight, [this](sf::RenderTarget& target) {
+            target.draw(playerHealthBar);
+            target.draw(hud);
+        });
+    }
+
+    // 開始第一關（在放進畫面堆疊之後呼叫）；遊戲開始畫面疊在第一關的關卡畫面上
+    bool start() {
+        if (!loadLevel(currentLevel)) {
+            return false;
+        }
+        requestBackground();
+        beginLevel();
+        if (!replaying) {
+            scenes.push(std::unique_ptr<Scene>(new MessageScene(font, "Welcome to Square vs Enemies!", campaign.gold,
+                                                                campaign.playerHealth, [this] { scenes.pop(); })));
+        }
+        return true;
+    }
+
+    int getExitCode() const {
+        return exitCode;
+    }
+
+    // 錄製檔在遊戲結束（或視窗關閉）時寫入
+    void finishRecording() {
+        if (recorder && recorder->save(recordPath, stateHash)) {
+            std::cout << "Recorded " << recorder->getTickCount() << " ticks to " << recordPath << std::endl;
+        }
+        recorder.reset();
+    }
+
+    void finishReplay() {
+        if (replaying) {
+            replaying = false;  // 重播結束，改由玩家繼續
+            reportReplayResult(replay.getRecording(), stateHash);
+        }
+    }
+
+    void handleEvent(const sf::Event& event) override {
+        if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::P) {
+            scenes.push(std::unique_ptr<Scene>(new PauseScene(scenes, font))); // 暫停遊戲
+        }
+    }
 
-            // 更新血量條與金幣顯示
-            playerHealthText.setString("Health: " + std::to_string(playerHealth) + "/" + std::to_string(maxPlayerHealth));
-            goldText.setString("Gold: " + std::to_string(gold));
-            playerHealthBar.setSize(sf::Vector2f(300 * (static_cast<float>(playerHealth) / maxPlayerHealth), 20));
-
-            // 繪製
-            window.clear(sf::Color::White);
-            window.draw(leftBoundary);
-            window.draw(rightBoundary);
-            window.draw(playerHealthBar);
-            window.draw(playerHealthText);
-            window.draw(goldText);
-            window.draw(bossNameText);
-            window.draw(square);
-            for (const auto& bullet : playerBullets) {
-                window.draw(bullet);
+    // 暫停或關卡畫面的時間不算進模擬
+    void resume() override {
+        timestep.reset();
+    }
+
+    bool isAnimated() const override {
+        return true;
+    }
+
+    void update() override {
+        timestep.advance([&](float dt) {
+            if (level->isFinished()) {
+                return;  // 同一幀剩下的 tick 不錄製，重播時才能對齊
+            }
+            TickInput input;
+            if (!replaying || !replay.nextTick(input)) {
+                finishReplay();
+                input = readHeldKeys();
             }
-            for (const auto& bullet : enemyBullets) {
-                window.draw(bullet);
+            if (recorder) {
+                recorder->recordTick(input);
             }
-            for (const auto& enemy : enemies) {
-                window.draw(enemy.shape);
+            level->tick(dt, input);
+            if (recorder || replaying) {
+                stateHash = level->getStateHash();
             }
-            window.display();
+        });
+        if (level->isFinished()) {
+            finishLevel();
+        }
+    }
+
+    void draw(sf::RenderTarget& target) override {
+        // 更新血量條與金幣顯示（改變時才重畫 HUD 圖層）
+        if (campaign.playerHealth != shownHealth || campaign.gold != shownGold || level->isBossAlive() != shownBoss) {
+            shownHealth = campaign.playerHealth;
+            shownGold = campaign.gold;
+            shownBoss = level->isBossAlive();
+            playerHealthText.setValues(shownHealth, maxPlayerHealth);
+            goldText.setValues(shownGold);
+            playerHealthBar.setSize(sf::Vector2f(300 * (static_cast<float>(shownHealth) / maxPlayerHealth), 20));
+            bossNameText.setVisible(shownBoss);
+            hudLayer.invalidate();
+        }
 
-            if (playerHealth <= 0) {
-                showLevelScreen(window, font, "Game Over!", gold, playerHealth);
-                return 0;
+        // 繪製（依上一個 tick 與目前 tick 插值）
+        const float alpha = timestep.getAlpha();
+
+        // 玩家、子彈、敵人依序合成一批（後加入的畫在上面）
+        entityBatch.begin(shapeTexture);
+        entityBatch.addQuad(
+            sf::FloatRect(interpolatePosition(level->previousPlayerPosition, level->playerPosition, alpha), playerSize),
+            playerColor, squareTexRect);
+        for (size_t i = 0; i < level->playerBullets.size(); ++i) {
+            entityBatch.addQuad(sf::FloatRect(level->playerBullets.getInterpolatedPosition(i, alpha), bulletSize),
+                                playerBulletColor, squareTexRect);
+        }
+        for (size_t i = 0; i < level->enemyBullets.size(); ++i) {
+            entityBatch.addQuad(sf::FloatRect(level->enemyBullets.getInterpolatedPosition(i, alpha), bulletSize),
+                                enemyBulletColor, squareTexRect);
+        }
+        const EntityStore& enemies = level->enemies;
+        for (size_t i = 0; i < enemies.size(); ++i) {
+            const sf::Color& color = level->getDefinition().archetypes[enemies.kind[i]].color;
+            entityBatch.addQuad(sf::FloatRect(enemies.getInterpolatedPosition(i, alpha),
+                                              sf::Vector2f(enemies.width[i], enemies.width[i])),
+                                color, circleTexRect);
+        }
+
+        target.draw(playfieldLayer);  // 不透明，蓋住整個畫面
+        target.draw(hudLayer);
+        target.draw(entityBatch);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    // 資源根目錄：--asset-root <目錄> 或環境變數 GTA6_ASSET_ROOT，預設為執行檔所在目錄
+    // --headless <tick 數> [--input-script <腳本>]：不開視窗，以腳本輸入執行模擬並回報 ticks/s
+    // --record <檔案>：把亂數種子、每個 tick 的輸入與商店購買錄到檔案；--replay <檔案>：重播
+    // --compile-levels：把 levels.txt 編譯成 levels.bin 後結束（啟動時若文字檔內容與 levels.bin 記錄的雜湊不同也會自動編譯）
+    AssetResolver assets(findAssetRoot(argc, argv));
+    unsigned long headlessTicks = 0;
+    bool compileLevelsOnly = false;
+    std::string inputScript = DEFAULT_INPUT_SCRIPT;
+    std::string recordPath;
+    std::string replayPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            headlessTicks = headlessDefaultTicks;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                headlessTicks = std::strtoul(argv[++i], nullptr, 10);
             }
+        } else if (std::strcmp(argv[i], "--input-script") == 0 && i + 1 < argc) {
+            inputScript = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--compile-levels") == 0) {
+            compileLevelsOnly = true;
         }
+    }
+
+    // 關卡資料
+    const std::string levelTextPath = assets.resolve(LEVEL_TEXT_FILE);
+    const std::string levelBinaryPath = assets.resolve(LEVEL_BINARY_FILE);
+    std::string levelMessage;
+    if (compileLevelsOnly) {
+        std::vector<LevelDefinition> levels;
+        const bool compiled = compileLevelFile(levelTextPath, levelBinaryPath, levels, levelMessage);
+        (compiled ? std::cout : std::cerr) << levelMessage << std::endl;
+        return compiled ? 0 : 1;
+    }
+    LevelLibrary library;
+    if (!library.open(levelTextPath, levelBinaryPath, levelMessage)) {
+        std::cerr << "Error: " << levelMessage << std::endl;
+        return 1;
+    }
+    if (!levelMessage.empty()) {
+        std::cout << levelMessage << std::endl;
+    }
 
-        if (playerHealth > 0 && currentLevel != 3) {
-            showShop(window, font, gold, playerHealth, bulletDamage, moveSpeed);
+    if (headlessTicks > 0) {
+        return runHeadless(library, headlessTicks, inputScript, recordPath, replayPath);
+    }
+
+    // 初始化隨機數：重播時使用錄製的種子，並略過需要按鍵的關卡畫面與商店
+    InputReplay replay;
+    bool replaying = false;
+    std::uint32_t seed = static_cast<std::uint32_t>(std::time(nullptr));
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            std::cerr << "Error: Could not load input recording " << replayPath << std::endl;
+            return 1;
         }
+        replaying = true;
+        seed = replay.getRecording().seed;
+    }
+    GameRandom random(seed);
+    std::unique_ptr<InputRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder.reset(new InputRecorder(seed, SIMULATION_TICK_RATE));
+    }
 
-        ++currentLevel;
+    // 創建視窗
+    sf::RenderWindow window(sf::VideoMode(windowWidth, windowHeight), "Square vs Enemies");
+    if (FRAME_RATE_LIMIT > 0) {
+        window.setFramerateLimit(FRAME_RATE_LIMIT);
+    }
+
+    // 字體
+    sf::Font font;
+    if (!font.loadFromFile(assets.resolve("arial.ttf"))) {
+        std::cerr << "Error: Could not load font!" << std::endl;
+        return -1;
     }
 
-    // 遊戲結束畫面
-    showLevelScreen(window, font, "Victory! Thanks for Playing!", gold, playerHealth);
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
-        return 0;
+    // 所有畫面都在同一個主迴圈中執行；靜態畫面沒有改變時不重畫
+    SceneStack scenes;
+    std::unique_ptr<PlayScene> playScene(new PlayScene(scenes, font, assets, library, random, replay, replaying,
+                                                       std::move(recorder), recordPath));
+    PlayScene& play = *playScene;
+    scenes.push(std::move(playScene));
+    if (!play.start()) {
+        return play.getExitCode();
     }
-    //return 0;
-}
+    scenes.run(window);
 
+    // 視窗在遊戲中途關閉時也寫入錄製檔
+    play.finishReplay();
+    play.finishRecording();
+    return play.getExitCode();
+}
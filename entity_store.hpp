@@ -0,0 +1,336 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include "fnv_hash.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 實體旗標
+enum EntityFlag : std::uint8_t {
+    ENTITY_BOSS = 1 << 0,
+    ENTITY_DEAD = 1 << 1,  // 已標記刪除，於 compact() 時一併移除
+};
+
+// 穩定的實體代號：實體被移除後 generation 會遞增，舊代號自動失效
+struct EntityHandle {
+    std::uint32_t slot = 0;
+    std::uint32_t generation = 0;  // 0 代表無效代號
+};
+
+// 結構陣列（SoA）實體儲存：每個欄位各自一條連續陣列，
+// 更新與碰撞只需線性掃過需要的欄位，繪製資料在繪製時才產生。
+// 移除採 swap-and-pop（O(1)），外部以 EntityHandle 穩定地指向實體；
+// 迭代中只標記 ENTITY_DEAD，tick 結束時再呼叫 compact() 統一移除。
+// 可以當作物件池使用：reserve() 預先配置容量，被移除實體的欄位與代號槽都會重複使用，
+// 數量不超過容量時新增實體不會配置記憶體；超過時照常成長並計入 getAllocationCount()
+class EntityStore {
+public:
+    std::vector<float> x, y;                  // 目前位置（左上角）
+    std::vector<float> previousX, previousY;  // 上一個 tick 的位置，用於插值繪製
+    std::vector<float> velocityX, velocityY;  // 每秒移動的像素
+    std::vector<float> width, height;         // 碰撞框大小
+    std::vector<int> health;
+    std::vector<std::uint8_t> flags;
+    std::vector<std::uint8_t> kind;           // 種類，由遊戲定義（例如關卡中的敵人原型），只用於繪製
+
+private:
+    std::vector<std::uint32_t> denseToSlot;      // 緊密索引 → 代號槽
+    std::vector<std::uint32_t> slotToDense;      // 代號槽 → 緊密索引
+    std::vector<std::uint32_t> slotGeneration;   // 代號槽目前的世代
+    std::vector<std::uint32_t> freeSlots;        // 可重複使用的代號槽
+    std::size_t allocationCount = 0;             // reserve() 之後因容量不足而重新配置的次數
+
+    // 把 from 的所有欄位搬到 to（from 之後會被丟棄）
+    void moveEntity(std::size_t from, std::size_t to) {
+        x[to] = x[from];
+        y[to] = y[from];
+        previousX[to] = previousX[from];
+        previousY[to] = previousY[from];
+        velocityX[to] = velocityX[from];
+        velocityY[to] = velocityY[from];
+        width[to] = width[from];
+        height[to] = height[from];
+        health[to] = health[from];
+        flags[to] = flags[from];
+        kind[to] = kind[from];
+        denseToSlot[to] = denseToSlot[from];
+        slotToDense[denseToSlot[to]] = static_cast<std::uint32_t>(to);
+    }
+
+    void popBack() {
+        x.pop_back();
+        y.pop_back();
+        previousX.pop_back();
+        previousY.pop_back();
+        velocityX.pop_back();
+        velocityY.pop_back();
+        width.pop_back();
+        height.pop_back();
+        health.pop_back();
+        flags.pop_back();
+        kind.pop_back();
+        denseToSlot.pop_back();
+    }
+
+public:
+    std::size_t size() const {
+        return x.size();
+    }
+
+    bool empty() const {
+        return x.empty();
+    }
+
+    // 預先配置 entityCount 個實體的空間
+    void reserve(std::size_t entityCount) {
+        x.reserve(entityCount);
+        y.reserve(entityCount);
+        previousX.reserve(entityCount);
+        previousY.reserve(entityCount);
+        velocityX.reserve(entityCount);
+        velocityY.reserve(entityCount);
+        width.reserve(entityCount);
+        height.reserve(entityCount);
+        health.reserve(entityCount);
+        flags.reserve(entityCount);
+        kind.reserve(entityCount);
+        denseToSlot.reserve(entityCount);
+        slotToDense.reserve(entityCount);
+        slotGeneration.reserve(entityCount);
+        freeSlots.reserve(entityCount);
+    }
+
+    std::size_t capacity() const {
+        return x.capacity();
+    }
+
+    std::size_t getAllocationCount() const {
+        return allocationCount;
+    }
+
+    EntityHandle add(float posX, float posY, float w, float h, float velX, float velY, int hp = 1, std::uint8_t entityFlags = 0,
+                     std::uint8_t entityKind = 0) {
+        if (size() == x.capacity() || (freeSlots.empty() && slotGeneration.size() == slotGeneration.capacity())) {
+            ++allocationCount;
+        }
+        std::uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<std::uint32_t>(slotGeneration.size());
+            slotGeneration.push_back(1);
+            slotToDense.push_back(0);
+        }
+        slotToDense[slot] = static_cast<std::uint32_t>(size());
+        denseToSlot.push_back(slot);
+
+        x.push_back(posX);
+        y.push_back(posY);
+        previousX.push_back(posX);
+        previousY.push_back(posY);
+        velocityX.push_back(velX);
+        velocityY.push_back(velY);
+        width.push_back(w);
+        height.push_back(h);
+        health.push_back(hp);
+        flags.push_back(entityFlags);
+        kind.push_back(entityKind);
+
+        EntityHandle handle;
+        handle.slot = slot;
+        handle.generation = slotGeneration[slot];
+        return handle;
+    }
+
+    // 一次新增 count 個相同大小與速度的實體，位置由呼叫端之後填入（可平行填寫）；
+    // 回傳第一個新實體的索引
+    std::size_t append(std::size_t count, float w, float h, float velX, float velY, int hp = 1, std::uint8_t entityFlags = 0) {
+        const std::size_t first = size();
+        const std::size_t total = first + count;
+        if (total > x.capacity()) {
+            ++allocationCount;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            std::uint32_t slot;
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                slot = static_cast<std::uint32_t>(slotGeneration.size());
+                slotGeneration.push_back(1);
+                slotToDense.push_back(0);
+            }
+            slotToDense[slot] = static_cast<std::uint32_t>(first + i);
+            denseToSlot.push_back(slot);
+        }
+        x.resize(total, 0.f);
+        y.resize(total, 0.f);
+        previousX.resize(total, 0.f);
+        previousY.resize(total, 0.f);
+        velocityX.resize(total, velX);
+        velocityY.resize(total, velY);
+        width.resize(total, w);
+        height.resize(total, h);
+        health.resize(total, hp);
+        flags.resize(total, entityFlags);
+        kind.resize(total, 0);
+        return first;
+    }
+
+    // 代號對應的緊密索引；實體已被移除時回傳 -1
+    long indexOf(EntityHandle handle) const {
+        if (handle.generation == 0 || handle.slot >= slotGeneration.size() ||
+            slotGeneration[handle.slot] != handle.generation) {
+            return -1;
+        }
+        return static_cast<long>(slotToDense[handle.slot]);
+    }
+
+    bool isAlive(EntityHandle handle) const {
+        long index = indexOf(handle);
+        return index >= 0 && !(flags[index] & ENTITY_DEAD);
+    }
+
+    EntityHandle handleAt(std::size_t index) const {
+        EntityHandle handle;
+        handle.slot = denseToSlot[index];
+        handle.generation = slotGeneration[handle.slot];
+        return handle;
+    }
+
+    // 標記刪除；實際移除延到 compact()，迭代中呼叫也不會改動索引
+    void kill(std::size_t index) {
+        flags[index] |= ENTITY_DEAD;
+    }
+
+    // 立即以 swap-and-pop 移除第 index 個實體（O(1)，最後一個實體會搬到 index）
+    void remove(std::size_t index) {
+        const std::uint32_t slot = denseToSlot[index];
+        if (++slotGeneration[slot] == 0) {
+            slotGeneration[slot] = 1;  // 世代溢位時跳過 0，保持 0 為無效代號
+        }
+        if (freeSlots.size() == freeSlots.capacity()) {
+            ++allocationCount;
+        }
+        freeSlots.push_back(slot);
+
+        const std::size_t last = size() - 1;
+        if (index != last) {
+            moveEntity(last, index);
+        }
+        popBack();
+    }
+
+    // tick 結束時呼叫：移除所有標記 ENTITY_DEAD 的實體。掃過所有實體一次（O(size)），
+    // 每個被移除的實體以 O(1) 的搬移取代
+    void compact() {
+        std::size_t index = 0;
+        while (index < size()) {
+            if (flags[index] & ENTITY_DEAD) {
+                remove(index);  // 搬過來的實體還沒檢查，所以不前進
+            } else {
+                ++index;
+            }
+        }
+    }
+
+    void clear() {
+        if (freeSlots.size() + denseToSlot.size() > freeSlots.capacity()) {
+            ++allocationCount;
+        }
+        for (std::uint32_t slot : denseToSlot) {
+            if (++slotGeneration[slot] == 0) {
+                slotGeneration[slot] = 1;
+            }
+            freeSlots.push_back(slot);
+        }
+        x.clear();
+        y.clear();
+        previousX.clear();
+        previousY.clear();
+        velocityX.clear();
+        velocityY.clear();
+        width.clear();
+        height.clear();
+        health.clear();
+        flags.clear();
+        kind.clear();
+        denseToSlot.clear();
+    }
+
+    // 依速度推進所有實體；每個欄位各自以向量化核心處理（見 simd_kernels.hpp）
+    void integrate(float deltaTime) {
+        integrateRange(0, size(), deltaTime);
+    }
+
+    // 只推進 [begin, end)；不同範圍可以在不同執行緒同時執行
+    void integrateRange(std::size_t begin, std::size_t end, float deltaTime) {
+        std::copy(x.begin() + begin, x.begin() + end, previousX.begin() + begin);
+        std::copy(y.begin() + begin, y.begin() + end, previousY.begin() + begin);
+        if (end > begin) {
+            const SimdKernels& kernels = simdKernels();
+            kernels.addScaled(x.data() + begin, velocityX.data() + begin, end - begin, deltaTime);
+            kernels.addScaled(y.data() + begin, velocityY.data() + begin, end - begin, deltaTime);
+        }
+    }
+
+    sf::FloatRect getBounds(std::size_t index) const {
+        return sf::FloatRect(x[index], y[index], width[index], height[index]);
+    }
+
+    // 所有實體狀態的雜湊，用來確認重播的結果與錄製時完全相同
+    std::uint64_t hashState(std::uint64_t hash = FNV_OFFSET_BASIS) const {
+        const std::size_t count = size();
+        hash = hashBytes(&count, sizeof(count), hash);
+        hash = hashBytes(x.data(), count * sizeof(float), hash);
+        hash = hashBytes(y.data(), count * sizeof(float), hash);
+        hash = hashBytes(velocityX.data(), count * sizeof(float), hash);
+        hash = hashBytes(velocityY.data(), count * sizeof(float), hash);
+        hash = hashBytes(health.data(), count * sizeof(int), hash);
+        return hashBytes(flags.data(), count, hash);
+    }
+
+    // 插值後的繪製位置
+    sf::Vector2f getInterpolatedPosition(std::size_t index, float alpha) const {
+        return sf::Vector2f(previousX[index] + (x[index] - previousX[index]) * alpha,
+                            previousY[index] + (y[index] - previousY[index]) * alpha);
+    }
+};
+
+// 與 sf::FloatRect::intersects 相同的判定（邊緣相接不算重疊）
+inline bool aabbOverlap(float ax, float ay, float aw, float ah, float bx, float by, float bw, float bh) {
+    return ax < bx + bw && bx < ax + aw && ay < by + bh && by < ay + ah;
+}
+
+inline bool entitiesOverlap(const EntityStore& a, std::size_t i, const EntityStore& b, std::size_t j) {
+    return aabbOverlap(a.x[i], a.y[i], a.width[i], a.height[i], b.x[j], b.y[j], b.width[j], b.height[j]);
+}
+
+inline bool entityOverlapsRect(const EntityStore& store, std::size_t i, const sf::FloatRect& rect) {
+    return aabbOverlap(store.x[i], store.y[i], store.width[i], store.height[i], rect.left, rect.top, rect.width, rect.height);
+}
+
+// 依索引順序對與 rect 重疊的每個實體呼叫 visit(index)（包含已標記刪除的實體），
+// visit 回傳 false 時停止；一次比對 8 個實體
+template <typename Visitor>
+void forEachEntityOverlapping(const EntityStore& store, const sf::FloatRect& rect, Visitor&& visit) {
+    forEachOverlap(SimdBox(rect.left, rect.top, rect.width, rect.height), store.x.data(), store.y.data(),
+                   store.width.data(), store.height.data(), store.size(), visit);
+}
+
+// 與 rect 重疊、尚未標記刪除且索引最小的實體；沒有時回傳 -1
+inline long findFirstEntityOverlapping(const EntityStore& store, const sf::FloatRect& rect) {
+    long first = -1;
+    forEachEntityOverlapping(store, rect, [&](std::size_t index) {
+        if (store.flags[index] & ENTITY_DEAD) {
+            return true;
+        }
+        first = static_cast<long>(index);
+        return false;
+    });
+    return first;
+}
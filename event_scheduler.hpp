@@ -0,0 +1,124 @@
+#pragma once
+
+#include "fnv_hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 以 tick 為單位的計時事件排程器（時間輪）：敵人生成、敵人齊射、無敵時間結束等定時事件
+// 排入後不再每個 tick 檢查，到期的那個 tick 才被取出。
+// WHEEL_SIZE 個 tick 以內的事件直接放進對應的格子（排入與取出都是 O(1)），
+// 更遠的事件先放在依到期時間排序的堆積，進入時間輪範圍時才搬進格子。
+//
+// 同一個 tick 到期的事件依排入順序觸發；排程只依賴 tick 數，結果是決定性的（重播一致）。
+// 格子與堆積保留容量，暖機後排入事件不再配置記憶體
+template <typename Event>
+class EventScheduler {
+public:
+    static const std::size_t WHEEL_SIZE = 256;  // 120 Hz 下約 2 秒
+
+private:
+    struct Timer {
+        std::uint64_t due;
+        std::uint64_t sequence;
+        Event event;
+    };
+
+    // 堆積頂端是最早到期（同時到期時最早排入）的事件
+    static bool firesLater(const Timer& a, const Timer& b) {
+        return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+    }
+
+    std::vector<Timer> wheel[WHEEL_SIZE];
+    std::vector<Timer> overflow;
+    std::uint64_t now;
+    std::uint64_t nextSequence = 0;
+    std::size_t pendingCount = 0;
+
+public:
+    explicit EventScheduler(std::uint64_t startTick = 0) : now(startTick) {}
+
+    // 目前的 tick（下一次 advance() 觸發這個 tick 到期的事件）
+    std::uint64_t getTick() const {
+        return now;
+    }
+
+    std::size_t getPendingCount() const {
+        return pendingCount;
+    }
+
+    // 在第 due 個 tick 觸發；已經過去的 tick 視為目前的 tick
+    void scheduleAt(std::uint64_t due, const Event& event) {
+        due = std::max(due, now);
+        const Timer timer = {due, nextSequence++, event};
+        if (due - now < WHEEL_SIZE) {
+            wheel[due % WHEEL_SIZE].push_back(timer);
+        } else {
+            overflow.push_back(timer);
+            std::push_heap(overflow.begin(), overflow.end(), firesLater);
+        }
+        ++pendingCount;
+    }
+
+    // 在 delay 個 tick 之後觸發；0 表示在目前的 tick 觸發（在 advance() 中排入時同一次就會觸發）
+    void schedule(std::uint64_t delay, const Event& event) {
+        scheduleAt(now + delay, event);
+    }
+
+    // 觸發目前 tick 到期的所有事件（依排入順序呼叫 handler(event)），然後前進一個 tick
+    template <typename Handler>
+    void advance(Handler&& handler) {
+        while (!overflow.empty() && overflow.front().due < now + WHEEL_SIZE) {
+            std::pop_heap(overflow.begin(), overflow.end(), firesLater);
+            wheel[overflow.back().due % WHEEL_SIZE].push_back(overflow.back());
+            overflow.pop_back();
+        }
+        std::vector<Timer>& slot = wheel[now % WHEEL_SIZE];
+        if (slot.size() > 1) {
+            // 從堆積搬進來的事件可能排在較晚排入的事件後面
+            std::sort(slot.begin(), slot.end(),
+                      [](const Timer& a, const Timer& b) { return a.sequence < b.sequence; });
+        }
+        // handler 可能在同一格排入新事件，以索引走訪並複製事件
+        for (std::size_t i = 0; i < slot.size(); ++i) {
+            const Event event = slot[i].event;
+            handler(event);
+        }
+        pendingCount -= slot.size();
+        slot.clear();
+        ++now;
+    }
+
+    // 移除所有事件並把時間設為 startTick
+    void clear(std::uint64_t startTick = 0) {
+        for (auto& slot : wheel) {
+            slot.clear();
+        }
+        overflow.clear();
+        now = startTick;
+        pendingCount = 0;
+    }
+
+    // 時間與待觸發事件的雜湊（Event 必須是可以逐位元組雜湊的型別）
+    std::uint64_t hashState(std::uint64_t hash = FNV_OFFSET_BASIS) const {
+        hash = hashBytes(&now, sizeof(now), hash);
+        for (std::uint64_t tick = now; tick < now + WHEEL_SIZE; ++tick) {
+            for (const Timer& timer : wheel[tick % WHEEL_SIZE]) {
+                hash = hashBytes(&timer.due, sizeof(timer.due), hash);
+                hash = hashBytes(&timer.event, sizeof(timer.event), hash);
+            }
+        }
+        for (const Timer& timer : overflow) {
+            hash = hashBytes(&timer.due, sizeof(timer.due), hash);
+            hash = hashBytes(&timer.event, sizeof(timer.event), hash);
+        }
+        return hash;
+    }
+};
+
+// 把秒數換成 tick 數（至少 1 個 tick）
+inline std::uint64_t ticksFromSeconds(float seconds, float tickRate) {
+    return std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::lround(seconds * tickRate)));
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cmath>
+
+// 模擬頻率（每秒 tick 數）與畫面上限，test.cpp 與 bike.cpp 共用
+const float SIMULATION_TICK_RATE = 120.f;
+const unsigned int FRAME_RATE_LIMIT = 144;  // 0 表示不限制幀率
+
+// 固定步長排程器：把每幀不固定的經過時間累積起來，
+// 以固定的步長推進模擬，讓遊戲速度與幀率無關
+class FixedTimestep {
+private:
+    sf::Clock clock;
+    float step;
+    float accumulator;
+    int maxTicksPerFrame;
+
+public:
+    explicit FixedTimestep(float ticksPerSecond = SIMULATION_TICK_RATE, int maxTicks = 8)
+        : step(1.f / ticksPerSecond), accumulator(0.f), maxTicksPerFrame(maxTicks) {}
+
+    // 以真實經過時間推進，每個 tick 呼叫一次 tick(step)，回傳本幀執行的 tick 數
+    template <typename TickFunction>
+    int advance(TickFunction&& tick) {
+        return advanceBy(clock.restart().asSeconds(), tick);
+    }
+
+    // 以指定的經過時間推進（給不依賴真實時間的呼叫端使用）
+    template <typename TickFunction>
+    int advanceBy(float elapsed, TickFunction&& tick) {
+        accumulator += elapsed;
+
+        int ticks = 0;
+        while (accumulator >= step && ticks < maxTicksPerFrame) {
+            tick(step);
+            accumulator -= step;
+            ++ticks;
+        }
+
+        // 落後太多時捨棄積欠的時間，避免越跑越慢的死亡螺旋
+        if (accumulator >= step) {
+            accumulator = std::fmod(accumulator, step);
+        }
+        return ticks;
+    }
+
+    // 暫停、切換畫面後呼叫，避免把等待時間算進模擬
+    void reset() {
+        clock.restart();
+        accumulator = 0.f;
+    }
+
+    // 目前位於兩個 tick 之間的比例 [0, 1)，用於插值繪製
+    float getAlpha() const {
+        return accumulator / step;
+    }
+
+    float getStep() const {
+        return step;
+    }
+
+    // 距離下一個 tick 還有幾秒（含這一幀尚未累計的時間），模擬執行緒據此休眠
+    float getTimeUntilNextStep() const {
+        const float remaining = step - accumulator - clock.getElapsedTime().asSeconds();
+        return remaining > 0.f ? remaining : 0.f;
+    }
+};
+
+// 插值繪製：上一個 tick 與目前 tick 之間的位置
+inline sf::Vector2f interpolatePosition(const sf::Vector2f& previous, const sf::Vector2f& current, float alpha) {
+    return previous + (current - previous) * alpha;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+const std::uint64_t FNV_OFFSET_BASIS = 1469598103934665603ULL;
+
+// FNV-1a 64 位元雜湊；傳入前一次的結果可以接續雜湊多段資料
+inline std::uint64_t hashBytes(const void* data, std::size_t size, std::uint64_t hash = FNV_OFFSET_BASIS) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+// 模擬專用的亂數產生器（PCG32）。與 rand() 不同，每個模擬各自持有狀態，
+// 輸出在任何平台與標準函式庫上都相同，錄製的種子可以完全重現一場遊戲
+class GameRandom {
+private:
+    static const std::uint64_t MULTIPLIER = 6364136223846793005ULL;
+    static const std::uint64_t INCREMENT = 1442695040888963407ULL;
+
+    std::uint64_t state = 0;
+
+public:
+    explicit GameRandom(std::uint32_t seed = 0) {
+        setSeed(seed);
+    }
+
+    void setSeed(std::uint32_t seed) {
+        state = 0;
+        next();
+        state += seed;
+        next();
+    }
+
+    std::uint32_t next() {
+        const std::uint64_t previous = state;
+        state = previous * MULTIPLIER + INCREMENT;
+        const std::uint32_t xorShifted = static_cast<std::uint32_t>(((previous >> 18u) ^ previous) >> 27u);
+        const std::uint32_t rotation = static_cast<std::uint32_t>(previous >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    // 跳過 steps 個輸出（O(log steps)），與呼叫 steps 次 next() 的結果相同。
+    // 平行產生時每個區塊複製一份並跳到自己的起點，輸出與依序產生完全一致
+    void advance(std::uint64_t steps) {
+        std::uint64_t multiplier = MULTIPLIER, increment = INCREMENT;
+        std::uint64_t totalMultiplier = 1, totalIncrement = 0;
+        while (steps > 0) {
+            if (steps & 1) {
+                totalMultiplier *= multiplier;
+                totalIncrement = totalIncrement * multiplier + increment;
+            }
+            increment = (multiplier + 1) * increment;
+            multiplier *= multiplier;
+            steps >>= 1;
+        }
+        state = totalMultiplier * state + totalIncrement;
+    }
+
+    // [0, 1] 的浮點數，取代 static_cast<float>(rand()) / RAND_MAX
+    float nextFloat() {
+        return static_cast<float>(next() >> 8) / static_cast<float>(0xFFFFFF);
+    }
+
+    // [0, bound) 的整數
+    int nextInt(int bound) {
+        return bound > 0 ? static_cast<int>(next() % static_cast<std::uint32_t>(bound)) : 0;
+    }
+};
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// HUD 文字元件：內容沒變時不重建字形頂點。
+// 以 printf 格式建立時（例如 "Gold: %ld"）只在數值改變才重新格式化，
+// 每幀呼叫 setValues() 不會配置字串
+class HudText {
+    friend class HudLayer;
+
+private:
+    const sf::Font* font;
+    unsigned int characterSize;
+    sf::Vector2f position;
+    sf::Color color;
+    std::string pattern;  // 空字串表示以 setString() 設定內容
+    std::string text;
+    long values[2] = {0, 0};
+    bool hasValues = false;
+    bool visible = true;
+    bool dirty = true;
+    std::vector<sf::Vertex> vertices;  // 以 Triangles 排列的字形方塊
+
+    // 與 sf::Text 相同的排版（不含粗體、斜體、外框）
+    void rebuild() {
+        vertices.clear();
+        dirty = false;
+        if (!visible) {
+            return;
+        }
+        const float whitespaceWidth = font->getGlyph(L' ', characterSize, false).advance;
+        const float lineSpacing = font->getLineSpacing(characterSize);
+        float x = 0.f;
+        float y = static_cast<float>(characterSize);
+        sf::Uint32 previous = 0;
+        for (unsigned char character : text) {
+            const sf::Uint32 current = character;
+            if (current == '\r') {
+                continue;
+            }
+            x += font->getKerning(previous, current, characterSize);
+            previous = current;
+            if (current == ' ' || current == '\t' || current == '\n') {
+                if (current == ' ') {
+                    x += whitespaceWidth;
+                } else if (current == '\t') {
+                    x += whitespaceWidth * 4;
+                } else {
+                    y += lineSpacing;
+                    x = 0.f;
+                }
+                continue;
+            }
+
+            const sf::Glyph& glyph = font->getGlyph(current, characterSize, false);
+            const float padding = 1.f;
+            const float left = position.x + x + glyph.bounds.left - padding;
+            const float top = position.y + y + glyph.bounds.top - padding;
+            const float right = left + glyph.bounds.width + 2.f * padding;
+            const float bottom = top + glyph.bounds.height + 2.f * padding;
+            const float u0 = glyph.textureRect.left - padding;
+            const float v0 = glyph.textureRect.top - padding;
+            const float u1 = glyph.textureRect.left + glyph.textureRect.width + padding;
+            const float v1 = glyph.textureRect.top + glyph.textureRect.height + padding;
+
+            vertices.push_back(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)));
+            vertices.push_back(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)));
+            vertices.push_back(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)));
+            vertices.push_back(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)));
+            vertices.push_back(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)));
+            vertices.push_back(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)));
+            x += glyph.advance;
+        }
+    }
+
+public:
+    HudText(const sf::Font& textFont, unsigned int size, const sf::Vector2f& textPosition, const sf::Color& textColor)
+        : font(&textFont), characterSize(size), position(textPosition), color(textColor) {}
+
+    void setString(const std::string& content) {
+        if (!pattern.empty() || content != text) {
+            pattern.clear();
+            text = content;
+            dirty = true;
+        }
+    }
+
+    // printf 格式，最多兩個 long（例如 "Health: %ld/%ld"）；格式中的字元會先載入字形
+    void setPattern(const std::string& format) {
+        if (format != pattern) {
+            pattern = format;
+            hasValues = false;
+            prewarmGlyphs(*font, characterSize, pattern);
+        }
+    }
+
+    void setValues(long first, long second = 0) {
+        if (hasValues && first == values[0] && second == values[1]) {
+            return;
+        }
+        values[0] = first;
+        values[1] = second;
+        hasValues = true;
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), pattern.c_str(), first, second);
+        text = buffer;
+        dirty = true;
+    }
+
+    void setColor(const sf::Color& textColor) {
+        if (textColor != color) {
+            color = textColor;
+            dirty = true;
+        }
+    }
+
+    void setPosition(const sf::Vector2f& textPosition) {
+        if (textPosition != position) {
+            position = textPosition;
+            dirty = true;
+        }
+    }
+
+    void setVisible(bool show) {
+        if (show != visible) {
+            visible = show;
+            dirty = true;
+        }
+    }
+
+    const std::string& getString() const {
+        return text;
+    }
+
+    // 先把數字與格式中的字元放進字型材質，遊戲中第一次出現新數字時才不必載入字形、擴大材質
+    static void prewarmGlyphs(const sf::Font& font, unsigned int size, const std::string& extra = "") {
+        for (char digit = '0'; digit <= '9'; ++digit) {
+            font.getGlyph(static_cast<sf::Uint32>(digit), size, false);
+        }
+        for (unsigned char character : extra) {
+            if (character > ' ' && character != '%') {
+                font.getGlyph(character, size, false);
+            }
+        }
+    }
+};
+
+// HUD 圖層：擁有多個 HudText，同一個字型材質（字型 + 字級）的文字合併成一個頂點陣列，
+// 每個字型材質一次 draw call。只有元件內容改變時才重建頂點陣列
+class HudLayer : public sf::Drawable {
+private:
+    struct Page {
+        const sf::Font* font;
+        unsigned int characterSize;
+        sf::VertexArray vertices;
+    };
+
+    std::vector<std::unique_ptr<HudText>> widgets;
+    mutable std::vector<Page> pages;
+
+    // 繪製前重建改變過的元件，並重新串接所屬頁面的頂點
+    void refresh() const {
+        std::vector<bool> pageDirty(pages.size(), false);
+        for (const auto& widget : widgets) {
+            if (widget->dirty) {
+                widget->rebuild();
+                pageDirty[findPage(*widget)] = true;
+            }
+        }
+        for (std::size_t page = 0; page < pages.size(); ++page) {
+            if (!pageDirty[page]) {
+                continue;
+            }
+            sf::VertexArray& vertices = pages[page].vertices;
+            vertices.clear();
+            for (const auto& widget : widgets) {
+                if (widget->font == pages[page].font && widget->characterSize == pages[page].characterSize) {
+                    for (const sf::Vertex& vertex : widget->vertices) {
+                        vertices.append(vertex);
+                    }
+                }
+            }
+        }
+    }
+
+    std::size_t findPage(const HudText& widget) const {
+        for (std::size_t page = 0; page < pages.size(); ++page) {
+            if (pages[page].font == widget.font && pages[page].characterSize == widget.characterSize) {
+                return page;
+            }
+        }
+        return 0;
+    }
+
+public:
+    // 加入一個元件；回傳的參考在圖層存在期間都有效
+    HudText& add(const sf::Font& font, unsigned int size, const sf::Vector2f& position, const sf::Color& color,
+                 const std::string& text = "") {
+        widgets.emplace_back(new HudText(font, size, position, color));
+        HudText& widget = *widgets.back();
+        widget.setString(text);
+        bool pageExists = false;
+        for (const auto& page : pages) {
+            pageExists = pageExists || (page.font == &font && page.characterSize == size);
+        }
+        if (!pageExists) {
+            HudText::prewarmGlyphs(font, size);
+            pages.push_back({&font, size, sf::VertexArray(sf::Triangles)});
+        }
+        return widget;
+    }
+
+    // 每幀的 draw call 數量
+    std::size_t getPageCount() const {
+        return pages.size();
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        refresh();
+        for (const auto& page : pages) {
+            if (page.vertices.getVertexCount() > 0) {
+                states.texture = &page.font->getTexture(page.characterSize);
+                target.draw(page.vertices, states);
+            }
+        }
+    }
+};
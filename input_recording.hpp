@@ -0,0 +1,175 @@
+#pragma once
+
+#include "tick_input.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 輸入錄製檔：亂數種子加上每個 tick 的輸入，重播時可以逐 tick 重現同一場遊戲。
+// 相同輸入連續出現時合併成一筆，檔案通常只有幾 KB。
+//
+// 檔案格式（little-endian）：
+//   標頭  : "GTA6REC\0"、uint32 版本、uint32 種子、uint32 旗標、float tick 頻率、
+//           uint64 tick 數、uint64 結束時的狀態雜湊、uint32 項目數
+//   每一項: uint8 種類、uint8 值、uint32 次數
+
+// 版本 2：定時事件改以整數 tick 排程，版本 1 的錄製檔重播結果不同
+const std::uint32_t INPUT_RECORDING_VERSION = 2;
+
+// 錄製旗標
+const std::uint32_t RECORDING_STRESS = 1 << 0;  // test.cpp 的壓力測試模式
+
+enum RecordingEntryKind : std::uint8_t {
+    RECORD_TICKS = 0,    // 值為按鍵，次數為連續 tick 數
+    RECORD_UPGRADE = 1,  // bike.cpp 商店購買，值為選項
+};
+
+struct InputRecording {
+    struct Entry {
+        std::uint8_t kind;
+        std::uint8_t value;
+        std::uint32_t count;
+    };
+
+    std::uint32_t seed = 0;
+    std::uint32_t flags = 0;
+    float tickRate = 0.f;
+    std::uint64_t tickCount = 0;
+    std::uint64_t finalStateHash = 0;
+    std::vector<Entry> entries;
+
+    bool save(const std::string& path) const {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        auto writeValue = [&](const void* value, std::size_t size) { std::fwrite(value, 1, size, file); };
+        const std::uint32_t version = INPUT_RECORDING_VERSION;
+        const std::uint32_t entryCount = static_cast<std::uint32_t>(entries.size());
+        writeValue("GTA6REC", 8);
+        writeValue(&version, sizeof(version));
+        writeValue(&seed, sizeof(seed));
+        writeValue(&flags, sizeof(flags));
+        writeValue(&tickRate, sizeof(tickRate));
+        writeValue(&tickCount, sizeof(tickCount));
+        writeValue(&finalStateHash, sizeof(finalStateHash));
+        writeValue(&entryCount, sizeof(entryCount));
+        for (const auto& entry : entries) {
+            writeValue(&entry.kind, sizeof(entry.kind));
+            writeValue(&entry.value, sizeof(entry.value));
+            writeValue(&entry.count, sizeof(entry.count));
+        }
+        const bool ok = std::ferror(file) == 0;
+        std::fclose(file);
+        return ok;
+    }
+
+    bool load(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        auto readValue = [&](void* value, std::size_t size) { return std::fread(value, 1, size, file) == size; };
+        char magic[8];
+        std::uint32_t version = 0, entryCount = 0;
+        bool ok = readValue(magic, sizeof(magic)) && std::memcmp(magic, "GTA6REC", 8) == 0 &&
+                  readValue(&version, sizeof(version)) && version == INPUT_RECORDING_VERSION &&
+                  readValue(&seed, sizeof(seed)) && readValue(&flags, sizeof(flags)) &&
+                  readValue(&tickRate, sizeof(tickRate)) && readValue(&tickCount, sizeof(tickCount)) &&
+                  readValue(&finalStateHash, sizeof(finalStateHash)) && readValue(&entryCount, sizeof(entryCount));
+        entries.clear();
+        for (std::uint32_t i = 0; ok && i < entryCount; ++i) {
+            Entry entry;
+            ok = readValue(&entry.kind, sizeof(entry.kind)) && readValue(&entry.value, sizeof(entry.value)) &&
+                 readValue(&entry.count, sizeof(entry.count));
+            entries.push_back(entry);
+        }
+        std::fclose(file);
+        return ok;
+    }
+};
+
+// 錄製：每個 tick 呼叫 recordTick()，結束時以 save() 寫入最終狀態雜湊
+class InputRecorder {
+private:
+    InputRecording recording;
+
+public:
+    InputRecorder(std::uint32_t seed, float tickRate, std::uint32_t flags = 0) {
+        recording.seed = seed;
+        recording.tickRate = tickRate;
+        recording.flags = flags;
+    }
+
+    void recordTick(const TickInput& input) {
+        ++recording.tickCount;
+        if (!recording.entries.empty()) {
+            InputRecording::Entry& last = recording.entries.back();
+            if (last.kind == RECORD_TICKS && last.value == input.buttons && last.count < UINT32_MAX) {
+                ++last.count;
+                return;
+            }
+        }
+        recording.entries.push_back({RECORD_TICKS, input.buttons, 1});
+    }
+
+    void recordUpgrade(std::uint8_t option) {
+        recording.entries.push_back({RECORD_UPGRADE, option, 1});
+    }
+
+    std::uint64_t getTickCount() const {
+        return recording.tickCount;
+    }
+
+    bool save(const std::string& path, std::uint64_t finalStateHash) {
+        recording.finalStateHash = finalStateHash;
+        return recording.save(path);
+    }
+};
+
+// 重播：依序取出錄製的 tick 輸入與商店購買
+class InputReplay {
+private:
+    InputRecording recording;
+    std::size_t entry = 0;
+    std::uint32_t usedInEntry = 0;
+
+public:
+    bool load(const std::string& path) {
+        entry = 0;
+        usedInEntry = 0;
+        return recording.load(path);
+    }
+
+    const InputRecording& getRecording() const {
+        return recording;
+    }
+
+    bool isFinished() const {
+        return entry >= recording.entries.size();
+    }
+
+    // 下一筆是商店購買時取出並回傳 true
+    bool nextUpgrade(std::uint8_t& option) {
+        if (isFinished() || recording.entries[entry].kind != RECORD_UPGRADE) {
+            return false;
+        }
+        option = recording.entries[entry++].value;
+        return true;
+    }
+
+    // 下一筆是 tick 輸入時取出一個 tick；播完或下一筆是商店購買時回傳 false
+    bool nextTick(TickInput& input) {
+        if (isFinished() || recording.entries[entry].kind != RECORD_TICKS) {
+            return false;
+        }
+        input.buttons = recording.entries[entry].value;
+        if (++usedInEntry >= recording.entries[entry].count) {
+            ++entry;
+            usedInEntry = 0;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 工作竊取（work-stealing）的工作系統：parallelFor() 把區間切成固定大小的區塊，
+// 輪流放進每個工作執行緒的佇列；執行緒先從自己佇列的尾端取，空了就從其他佇列的前端偷，
+// 呼叫端在等待期間也一起執行區塊。
+//
+// 區塊的執行順序不固定，呼叫端要讓每個區塊只寫入自己的索引範圍，
+// 需要合併的結果（例如碰撞）寫到以索引排列的陣列，之後再依索引順序合併，
+// 結果才會與單執行緒完全相同（重播仍然一致）
+class JobSystem {
+private:
+    struct Batch {
+        void (*run)(void* context, std::size_t begin, std::size_t end);
+        void* context;
+        std::atomic<std::size_t> remaining;
+    };
+
+    struct Job {
+        Batch* batch;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // 固定容量的環狀佇列，推入與取出都不配置記憶體
+    struct WorkerQueue {
+        static const std::size_t CAPACITY = 1024;
+        std::mutex mutex;
+        Job jobs[CAPACITY];
+        std::size_t head = 0;  // 竊取端（最舊）
+        std::size_t count = 0;
+
+        bool push(const Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == CAPACITY) {
+                return false;
+            }
+            jobs[(head + count) % CAPACITY] = job;
+            ++count;
+            return true;
+        }
+
+        // 擁有者從尾端取（最新，快取較熱）
+        bool popBack(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0) {
+                return false;
+            }
+            --count;
+            job = jobs[(head + count) % CAPACITY];
+            return true;
+        }
+
+        // 其他執行緒從前端偷
+        bool stealFront(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == 0) {
+                return false;
+            }
+            job = jobs[head];
+            head = (head + 1) % CAPACITY;
+            --count;
+            return true;
+        }
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<std::size_t> pending{0};  // 尚未被取走的區塊數
+    bool stopping = false;
+
+    template <typename RangeFunction>
+    static void invoke(void* context, std::size_t begin, std::size_t end) {
+        (*static_cast<RangeFunction*>(context))(begin, end);
+    }
+
+    static void execute(const Job& job) {
+        job.batch->run(job.batch->context, job.begin, job.end);
+        job.batch->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // 先取 preferred 佇列，再依序偷其他佇列
+    bool findJob(std::size_t preferred, Job& job) {
+        const std::size_t queueCount = queues.size();
+        if (preferred < queueCount && queues[preferred]->popBack(job)) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        for (std::size_t offset = 1; offset <= queueCount; ++offset) {
+            const std::size_t victim = (preferred + offset) % queueCount;
+            if (queues[victim]->stealFront(job)) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(std::size_t index) {
+        for (;;) {
+            Job job;
+            if (findJob(index, job)) {
+                execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wakeUp.wait(lock, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+
+public:
+    // threadCount 包含呼叫端；0 表示使用所有核心，1 表示不建立執行緒、全部在呼叫端執行
+    explicit JobSystem(unsigned int threadCount = 0) {
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned int i = 1; i < threadCount; ++i) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (std::size_t i = 0; i < queues.size(); ++i) {
+            workers.emplace_back(&JobSystem::workerLoop, this, i);
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned int getThreadCount() const {
+        return static_cast<unsigned int>(workers.size() + 1);
+    }
+
+    // 以 grainSize 為單位把 [0, count) 分給所有執行緒，全部完成後才返回。
+    // 數量不超過一個區塊或沒有工作執行緒時直接在呼叫端執行
+    template <typename RangeFunction>
+    void parallelFor(std::size_t count, std::size_t grainSize, RangeFunction&& function) {
+        grainSize = std::max<std::size_t>(grainSize, 1);
+        if (workers.empty() || count <= grainSize) {
+            if (count > 0) {
+                function(std::size_t(0), count);
+            }
+            return;
+        }
+
+        using Function = typename std::remove_reference<RangeFunction>::type;
+        Batch batch;
+        batch.run = &invoke<Function>;
+        batch.context = const_cast<void*>(static_cast<const void*>(&function));
+        const std::size_t chunkCount = (count + grainSize - 1) / grainSize;
+        batch.remaining.store(chunkCount, std::memory_order_relaxed);
+
+        // 先計入待執行數量再推入，取走區塊時的遞減才不會先於遞增；
+        // 輪流分配，佇列滿時由呼叫端直接執行該區塊
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending.fetch_add(chunkCount, std::memory_order_relaxed);
+        }
+        std::vector<Job> overflow;
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            const Job job = {&batch, chunk * grainSize, std::min(count, (chunk + 1) * grainSize)};
+            if (!queues[chunk % queues.size()]->push(job)) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                overflow.push_back(job);
+            }
+        }
+        wakeUp.notify_all();
+
+        for (const Job& job : overflow) {
+            execute(job);
+        }
+        // 呼叫端也幫忙執行，直到這一批全部完成
+        std::size_t next = 0;
+        while (batch.remaining.load(std::memory_order_acquire) > 0) {
+            Job job;
+            if (findJob(next++ % queues.size(), job)) {
+                execute(job);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+// jobs 為空時在呼叫端依序執行
+template <typename RangeFunction>
+void parallelFor(JobSystem* jobs, std::size_t count, std::size_t grainSize, RangeFunction&& function) {
+    if (jobs) {
+        jobs->parallelFor(count, grainSize, function);
+    } else if (count > 0) {
+        function(std::size_t(0), count);
+    }
+}
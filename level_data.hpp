@@ -0,0 +1,452 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include "fnv_hash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 關卡定義：設計者編輯文字檔（levels.txt），啟動時編譯成精簡的二進位檔（levels.bin），
+// 之後每一關只在需要時從二進位檔讀出，新增關卡不必重新編譯遊戲。
+// 二進位檔記錄來源文字檔的雜湊，文字檔改過時自動重新編譯。
+//
+// 文字格式（# 之後為註解，每行一個指令）：
+//   archetype <名稱> <半徑> <血量> <移動速度> <R> <G> <B>   敵人原型，所有關卡共用
+//   level <名稱>                           開始新的一關，之後的指令屬於這一關
+//   max_active <數量>                      同時存在的敵人上限
+//   wave <原型> <數量>                     依序生成，前一波生成完才開始下一波
+//   boss <名稱> <原型> <已生成數量>         生成第 N 個敵人後出現 BOSS（算在擊敗數中）
+//   background <路徑> <不透明度 0-255>     背景圖片（相對於資源根目錄，可省略）
+//
+// 二進位格式（little-endian）：
+//   標頭    : "GTA6LVL\0"、uint32 版本、uint32 關卡數、uint64 來源雜湊
+//   索引表  : 每關 uint32 位移、uint32 大小
+//   每一關  : 字串（uint16 長度 + 內容）名稱、uint32 同時上限、
+//             uint8 原型數、每個原型 float 半徑、int32 血量、float 速度、uint8 R、G、B、
+//             uint32 波數、每波 uint8 原型、uint32 數量、
+//             uint8 有無 BOSS、字串 BOSS 名稱、uint8 BOSS 原型、uint32 BOSS 出現時的生成數、
+//             字串背景路徑、uint8 背景不透明度
+
+const std::uint32_t LEVEL_DATA_VERSION = 1;
+const std::string LEVEL_TEXT_FILE = "levels.txt";
+const std::string LEVEL_BINARY_FILE = "levels.bin";
+
+struct EnemyArchetype {
+    float radius = 50.f;
+    int health = 500;
+    float speed = 100.f;  // 左右移動速度（每秒像素）
+    sf::Color color;
+};
+
+struct SpawnWave {
+    std::uint8_t archetype = 0;  // LevelDefinition::archetypes 的索引
+    std::uint32_t count = 0;
+};
+
+struct LevelDefinition {
+    std::string name;
+    std::uint32_t maxActive = 5;
+    std::vector<EnemyArchetype> archetypes;  // 只包含這一關用到的原型
+    std::vector<SpawnWave> waves;
+    bool hasBoss = false;
+    std::string bossName;
+    std::uint8_t bossArchetype = 0;
+    std::uint32_t bossAfterSpawned = 0;
+    std::string background;
+    std::uint8_t backgroundAlpha = 255;
+
+    // 一般敵人的總數（過關需要擊敗的數量）
+    int getEnemyCount() const {
+        int count = 0;
+        for (const auto& wave : waves) {
+            count += static_cast<int>(wave.count);
+        }
+        return count;
+    }
+};
+
+// 沒有關卡檔時使用的內建關卡（原本寫在程式中的三關）
+const char* const DEFAULT_LEVEL_TEXT =
+    "archetype grunt 50 500 100 0 0 255\n"
+    "archetype boss 70 2500 100 255 0 255\n"
+    "level Level 1\nmax_active 5\nwave grunt 15\nboss rrro boss 7\n"
+    "level Level 2\nmax_active 5\nwave grunt 20\nboss IM_Head boss 10\n"
+    "level Level 3\nmax_active 5\nwave grunt 25\nboss syua_yuan_a_pei boss 12\n";
+
+// 解析關卡文字；失敗時 error 為 "第幾行：原因"
+inline bool parseLevelText(const std::string& text, std::vector<LevelDefinition>& levels, std::string& error) {
+    std::vector<std::string> archetypeNames;
+    std::vector<EnemyArchetype> archetypes;
+    std::vector<std::vector<int>> levelArchetypes;  // 每一關：關卡內索引 → 全域索引
+    levels.clear();
+
+    // 把全域原型加入目前這一關，回傳關卡內的索引
+    auto useArchetype = [&](const std::string& name, std::uint8_t& index) {
+        for (std::size_t global = 0; global < archetypeNames.size(); ++global) {
+            if (archetypeNames[global] != name) {
+                continue;
+            }
+            std::vector<int>& used = levelArchetypes.back();
+            for (std::size_t local = 0; local < used.size(); ++local) {
+                if (used[local] == static_cast<int>(global)) {
+                    index = static_cast<std::uint8_t>(local);
+                    return true;
+                }
+            }
+            if (used.size() >= 255) {
+                return false;
+            }
+            index = static_cast<std::uint8_t>(used.size());
+            used.push_back(static_cast<int>(global));
+            levels.back().archetypes.push_back(archetypes[global]);
+            return true;
+        }
+        return false;
+    };
+
+    auto isByte = [](int value) {
+        return value >= 0 && value <= 255;
+    };
+
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        std::string command;
+        if (!(fields >> command)) {
+            continue;
+        }
+        bool ok = true;
+        std::string reason = "invalid arguments";
+        if (command == "archetype") {
+            std::string name;
+            EnemyArchetype archetype;
+            int r, g, b;
+            ok = static_cast<bool>(fields >> name >> archetype.radius >> archetype.health >> archetype.speed >> r >> g >> b);
+            if (ok && !(isByte(r) && isByte(g) && isByte(b))) {
+                ok = false;
+                reason = "color out of range 0-255";
+            }
+            archetype.color = sf::Color(static_cast<sf::Uint8>(r), static_cast<sf::Uint8>(g), static_cast<sf::Uint8>(b));
+            archetypeNames.push_back(name);
+            archetypes.push_back(archetype);
+        } else if (command == "level") {
+            levels.push_back(LevelDefinition());
+            levelArchetypes.push_back(std::vector<int>());
+            std::string& name = levels.back().name;
+            std::getline(fields >> std::ws, name);
+            name.erase(name.find_last_not_of(" \t\r") + 1);
+            ok = !name.empty();
+        } else if (levels.empty()) {
+            ok = false;
+            reason = "'" + command + "' before the first level";
+        } else if (command == "max_active") {
+            ok = static_cast<bool>(fields >> levels.back().maxActive) && levels.back().maxActive > 0;
+        } else if (command == "wave") {
+            std::string name;
+            SpawnWave wave;
+            ok = static_cast<bool>(fields >> name >> wave.count);
+            if (ok && !useArchetype(name, wave.archetype)) {
+                ok = false;
+                reason = "unknown archetype '" + name + "'";
+            }
+            levels.back().waves.push_back(wave);
+        } else if (command == "boss") {
+            LevelDefinition& level = levels.back();
+            std::string name;
+            ok = static_cast<bool>(fields >> level.bossName >> name >> level.bossAfterSpawned);
+            if (ok && !useArchetype(name, level.bossArchetype)) {
+                ok = false;
+                reason = "unknown archetype '" + name + "'";
+            }
+            level.hasBoss = ok;
+        } else if (command == "background") {
+            int alpha = 255;
+            ok = static_cast<bool>(fields >> levels.back().background >> alpha);
+            if (ok && !isByte(alpha)) {
+                ok = false;
+                reason = "alpha out of range 0-255";
+            }
+            levels.back().backgroundAlpha = static_cast<std::uint8_t>(alpha);
+        } else {
+            ok = false;
+            reason = "unknown command '" + command + "'";
+        }
+        if (!ok) {
+            error = "line " + std::to_string(lineNumber) + ": " + reason;
+            return false;
+        }
+    }
+    if (levels.empty()) {
+        error = "no levels defined";
+        return false;
+    }
+    return true;
+}
+
+// 單一關卡序列化成二進位紀錄
+inline void serializeLevel(const LevelDefinition& level, std::vector<char>& out) {
+    auto writeValue = [&](const void* value, std::size_t size) {
+        const char* bytes = static_cast<const char*>(value);
+        out.insert(out.end(), bytes, bytes + size);
+    };
+    auto writeString = [&](const std::string& text) {
+        const std::uint16_t length = static_cast<std::uint16_t>(text.size());
+        writeValue(&length, sizeof(length));
+        writeValue(text.data(), length);
+    };
+    writeString(level.name);
+    writeValue(&level.maxActive, sizeof(level.maxActive));
+    const std::uint8_t archetypeCount = static_cast<std::uint8_t>(level.archetypes.size());
+    writeValue(&archetypeCount, sizeof(archetypeCount));
+    for (const auto& archetype : level.archetypes) {
+        const std::int32_t health = archetype.health;
+        writeValue(&archetype.radius, sizeof(archetype.radius));
+        writeValue(&health, sizeof(health));
+        writeValue(&archetype.speed, sizeof(archetype.speed));
+        const sf::Uint8 color[3] = {archetype.color.r, archetype.color.g, archetype.color.b};
+        writeValue(color, sizeof(color));
+    }
+    const std::uint32_t waveCount = static_cast<std::uint32_t>(level.waves.size());
+    writeValue(&waveCount, sizeof(waveCount));
+    for (const auto& wave : level.waves) {
+        writeValue(&wave.archetype, sizeof(wave.archetype));
+        writeValue(&wave.count, sizeof(wave.count));
+    }
+    const std::uint8_t hasBoss = level.hasBoss ? 1 : 0;
+    writeValue(&hasBoss, sizeof(hasBoss));
+    writeString(level.bossName);
+    writeValue(&level.bossArchetype, sizeof(level.bossArchetype));
+    writeValue(&level.bossAfterSpawned, sizeof(level.bossAfterSpawned));
+    writeString(level.background);
+    writeValue(&level.backgroundAlpha, sizeof(level.backgroundAlpha));
+}
+
+inline bool deserializeLevel(const std::vector<char>& data, LevelDefinition& level) {
+    std::size_t position = 0;
+    auto readValue = [&](void* value, std::size_t size) {
+        if (position + size > data.size()) {
+            return false;
+        }
+        std::copy(data.begin() + position, data.begin() + position + size, static_cast<char*>(value));
+        position += size;
+        return true;
+    };
+    auto readString = [&](std::string& text) {
+        std::uint16_t length = 0;
+        if (!readValue(&length, sizeof(length)) || position + length > data.size()) {
+            return false;
+        }
+        text.assign(data.begin() + position, data.begin() + position + length);
+        position += length;
+        return true;
+    };
+    std::uint8_t archetypeCount = 0;
+    if (!readString(level.name) || !readValue(&level.maxActive, sizeof(level.maxActive)) ||
+        !readValue(&archetypeCount, sizeof(archetypeCount))) {
+        return false;
+    }
+    level.archetypes.resize(archetypeCount);
+    for (auto& archetype : level.archetypes) {
+        std::int32_t health = 0;
+        sf::Uint8 color[3];
+        if (!readValue(&archetype.radius, sizeof(archetype.radius)) || !readValue(&health, sizeof(health)) ||
+            !readValue(&archetype.speed, sizeof(archetype.speed)) || !readValue(color, sizeof(color))) {
+            return false;
+        }
+        archetype.health = health;
+        archetype.color = sf::Color(color[0], color[1], color[2]);
+    }
+    std::uint32_t waveCount = 0;
+    if (!readValue(&waveCount, sizeof(waveCount))) {
+        return false;
+    }
+    level.waves.resize(waveCount);
+    for (auto& wave : level.waves) {
+        if (!readValue(&wave.archetype, sizeof(wave.archetype)) || !readValue(&wave.count, sizeof(wave.count)) ||
+            wave.archetype >= archetypeCount) {
+            return false;
+        }
+    }
+    std::uint8_t hasBoss = 0;
+    if (!readValue(&hasBoss, sizeof(hasBoss)) || !readString(level.bossName) ||
+        !readValue(&level.bossArchetype, sizeof(level.bossArchetype)) ||
+        !readValue(&level.bossAfterSpawned, sizeof(level.bossAfterSpawned)) || !readString(level.background) ||
+        !readValue(&level.backgroundAlpha, sizeof(level.backgroundAlpha))) {
+        return false;
+    }
+    level.hasBoss = hasBoss != 0 && level.bossArchetype < archetypeCount;
+    return true;
+}
+
+// 把所有關卡寫成二進位檔
+inline bool writeLevelBinary(const std::vector<LevelDefinition>& levels, std::uint64_t sourceHash,
+                             const std::string& path) {
+    std::vector<std::vector<char>> records(levels.size());
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        serializeLevel(levels[i], records[i]);
+    }
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    auto writeValue = [&](const void* value, std::size_t size) { std::fwrite(value, 1, size, file); };
+    const std::uint32_t version = LEVEL_DATA_VERSION;
+    const std::uint32_t levelCount = static_cast<std::uint32_t>(levels.size());
+    writeValue("GTA6LVL", 8);
+    writeValue(&version, sizeof(version));
+    writeValue(&levelCount, sizeof(levelCount));
+    writeValue(&sourceHash, sizeof(sourceHash));
+    std::uint32_t offset = 8 + 4 + 4 + 8 + levelCount * 8;
+    for (const auto& record : records) {
+        const std::uint32_t size = static_cast<std::uint32_t>(record.size());
+        writeValue(&offset, sizeof(offset));
+        writeValue(&size, sizeof(size));
+        offset += size;
+    }
+    for (const auto& record : records) {
+        writeValue(record.data(), record.size());
+    }
+    const bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+    return ok;
+}
+
+inline bool readLevelText(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// 把文字檔編譯成二進位檔；levels 為解析結果（寫入失敗時呼叫端仍可直接使用）
+inline bool compileLevelFile(const std::string& textPath, const std::string& binaryPath,
+                             std::vector<LevelDefinition>& levels, std::string& message) {
+    std::string text;
+    if (!readLevelText(textPath, text)) {
+        message = "Could not read " + textPath;
+        return false;
+    }
+    std::string error;
+    if (!parseLevelText(text, levels, error)) {
+        levels.clear();
+        message = textPath + " " + error;
+        return false;
+    }
+    if (!writeLevelBinary(levels, hashBytes(text.data(), text.size()), binaryPath)) {
+        message = "Could not write " + binaryPath;
+        return false;
+    }
+    message = "Compiled " + std::to_string(levels.size()) + " levels from " + textPath + " to " + binaryPath;
+    return true;
+}
+
+// 關卡庫：開啟時只讀標頭與索引表，load() 才讀出單一關卡。
+// 沒有二進位檔可用時改為保留解析好的關卡（例如內建關卡或無法寫入的目錄）
+class LevelLibrary {
+private:
+    struct IndexEntry {
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    std::string binaryPath;
+    std::vector<IndexEntry> index;
+    std::vector<LevelDefinition> inMemory;
+    std::uint64_t sourceHash = 0;
+
+    bool openBinary(const std::string& path) {
+        index.clear();
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        auto readValue = [&](void* value, std::size_t size) { return std::fread(value, 1, size, file) == size; };
+        char magic[8];
+        std::uint32_t version = 0, levelCount = 0;
+        bool ok = readValue(magic, sizeof(magic)) && std::string(magic, 7) == "GTA6LVL" &&
+                  readValue(&version, sizeof(version)) && version == LEVEL_DATA_VERSION &&
+                  readValue(&levelCount, sizeof(levelCount)) && readValue(&sourceHash, sizeof(sourceHash));
+        for (std::uint32_t i = 0; ok && i < levelCount; ++i) {
+            IndexEntry entry;
+            ok = readValue(&entry.offset, sizeof(entry.offset)) && readValue(&entry.size, sizeof(entry.size));
+            index.push_back(entry);
+        }
+        std::fclose(file);
+        if (!ok) {
+            index.clear();
+            return false;
+        }
+        binaryPath = path;
+        return true;
+    }
+
+public:
+    // 開啟 binaryPath；textPath 存在且與二進位檔的來源雜湊不同時先重新編譯。
+    // 兩者都沒有時使用內建關卡。message 為要顯示給使用者的說明（編譯結果或錯誤）
+    bool open(const std::string& textPath, const std::string& binaryFile, std::string& message) {
+        inMemory.clear();
+        std::string text;
+        if (readLevelText(textPath, text)) {
+            if (openBinary(binaryFile) && sourceHash == hashBytes(text.data(), text.size())) {
+                return true;
+            }
+            index.clear();
+            std::vector<LevelDefinition> levels;
+            if (compileLevelFile(textPath, binaryFile, levels, message) && openBinary(binaryFile)) {
+                return true;
+            }
+            if (levels.empty()) {
+                return false;  // 文字檔有錯誤
+            }
+            message += ", keeping levels in memory";
+            inMemory = levels;
+            return true;
+        }
+        if (openBinary(binaryFile)) {
+            return true;
+        }
+        std::string error;
+        parseLevelText(DEFAULT_LEVEL_TEXT, inMemory, error);
+        message = "No level file found, using built-in levels";
+        return true;
+    }
+
+    std::size_t getLevelCount() const {
+        return inMemory.empty() ? index.size() : inMemory.size();
+    }
+
+    // 讀出第 number 關（從 1 開始）
+    bool load(std::size_t number, LevelDefinition& level) const {
+        if (number < 1 || number > getLevelCount()) {
+            return false;
+        }
+        if (!inMemory.empty()) {
+            level = inMemory[number - 1];
+            return true;
+        }
+        const IndexEntry& entry = index[number - 1];
+        std::FILE* file = std::fopen(binaryPath.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        std::vector<char> record(entry.size);
+        const bool ok = std::fseek(file, static_cast<long>(entry.offset), SEEK_SET) == 0 &&
+                        std::fread(record.data(), 1, record.size(), file) == record.size();
+        std::fclose(file);
+        return ok && deserializeLevel(record, level);
+    }
+};
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 非同步日誌：呼叫端只把格式化好的訊息放進無鎖環狀緩衝區，
+// 由背景執行緒寫到標準輸出，遊戲迴圈不會因為 std::endl 的同步 flush 而卡住。
+// 緩衝區滿或超過每秒上限時丟棄訊息並計數（警告與錯誤不受每秒上限限制），
+// 背景執行緒會回報丟棄的數量。
+//
+// LOG_DEBUG 在編譯期移除：定義 NDEBUG（release）時預設只保留 INFO 以上，
+// 也可以用 -DGTA6_LOG_MIN_LEVEL=<0..3> 指定
+
+enum LogLevel {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO = 1,
+    LOG_LEVEL_WARN = 2,
+    LOG_LEVEL_ERROR = 3,
+};
+
+#ifndef GTA6_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define GTA6_LOG_MIN_LEVEL 1
+#else
+#define GTA6_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GTA6_PRINTF_FORMAT(formatIndex, firstArgument) __attribute__((format(printf, formatIndex, firstArgument)))
+#else
+#define GTA6_PRINTF_FORMAT(formatIndex, firstArgument)
+#endif
+
+class Logger {
+private:
+    static const std::size_t CAPACITY = 4096;       // 必須是 2 的次方
+    static const std::size_t MESSAGE_SIZE = 232;    // 超過的部分截斷
+    static const unsigned int DEFAULT_RATE_LIMIT = 500;  // 每秒最多幾則 DEBUG/INFO
+
+    struct Message {
+        std::uint8_t level;
+        std::uint32_t timeMs;
+        char text[MESSAGE_SIZE];
+    };
+
+    // 每一格的序號表示狀態：等於寫入位置時可寫，等於寫入位置 + 1 時可讀
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Message message;
+    };
+
+    std::vector<Slot> slots;
+    std::atomic<std::size_t> enqueuePosition{0};
+    std::size_t dequeuePosition = 0;  // 只有背景執行緒使用
+    std::atomic<int> minimumLevel{GTA6_LOG_MIN_LEVEL};
+    std::atomic<unsigned int> rateLimit{DEFAULT_RATE_LIMIT};
+    std::atomic<std::uint32_t> rateWindow{0};
+    std::atomic<unsigned int> rateCount{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> accepted{0};
+    std::atomic<bool> running{true};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread writer;
+
+    Logger() : slots(CAPACITY) {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread(&Logger::writeLoop, this);
+    }
+
+    std::uint32_t elapsedMs() const {
+        return static_cast<std::uint32_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // 每秒上限（以一秒為一個視窗，計數不需要精確）
+    bool withinRateLimit(std::uint32_t timeMs) {
+        const std::uint32_t window = timeMs / 1000;
+        if (rateWindow.load(std::memory_order_relaxed) != window) {
+            rateWindow.store(window, std::memory_order_relaxed);
+            rateCount.store(0, std::memory_order_relaxed);
+        }
+        return rateCount.fetch_add(1, std::memory_order_relaxed) < rateLimit.load(std::memory_order_relaxed);
+    }
+
+    // 取出一則訊息；只在背景執行緒呼叫
+    bool dequeue(Message& message) {
+        Slot& slot = slots[dequeuePosition & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            return false;
+        }
+        message = slot.message;
+        slot.sequence.store(dequeuePosition + CAPACITY, std::memory_order_release);
+        ++dequeuePosition;
+        return true;
+    }
+
+    // 一次取出所有訊息後才寫出並 flush；沒有訊息時短暫休眠。
+    // 丟棄的數量最多每秒回報一次
+    void writeLoop() {
+        static const char* const levelNames[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+        std::string batch;
+        std::uint64_t reportedDrops = 0;
+        std::uint32_t lastReportMs = 0;
+        Message message;
+        for (;;) {
+            const bool stopping = !running.load(std::memory_order_acquire);
+            std::uint64_t count = 0;
+            batch.clear();
+            while (dequeue(message)) {
+                char prefix[32];
+                std::snprintf(prefix, sizeof(prefix), "[%7.3f %-5s] ", message.timeMs / 1000.0, levelNames[message.level]);
+                batch += prefix;
+                batch += message.text;
+                batch += '\n';
+                ++count;
+            }
+            const std::uint64_t drops = dropped.load(std::memory_order_relaxed);
+            const std::uint32_t timeMs = elapsedMs();
+            if (drops != reportedDrops && (stopping || timeMs - lastReportMs >= 1000)) {
+                batch += "[log] " + std::to_string(drops - reportedDrops) + " messages dropped\n";
+                reportedDrops = drops;
+                lastReportMs = timeMs;
+            }
+            if (!batch.empty()) {
+                std::fwrite(batch.data(), 1, batch.size(), stdout);
+                std::fflush(stdout);
+                written.fetch_add(count, std::memory_order_release);
+            } else if (stopping) {
+                return;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+public:
+    static Logger& get() {
+        static Logger instance;
+        return instance;
+    }
+
+    ~Logger() {
+        running.store(false, std::memory_order_release);
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // 執行期再提高門檻（不能低於編譯期的 GTA6_LOG_MIN_LEVEL）
+    void setMinimumLevel(LogLevel level) {
+        minimumLevel.store(level > GTA6_LOG_MIN_LEVEL ? level : GTA6_LOG_MIN_LEVEL, std::memory_order_relaxed);
+    }
+
+    // 每秒最多寫入幾則 DEBUG/INFO
+    void setRateLimit(unsigned int messagesPerSecond) {
+        rateLimit.store(messagesPerSecond, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getDroppedCount() const {
+        return dropped.load(std::memory_order_relaxed);
+    }
+
+    // printf 格式；任何執行緒都可以呼叫，不會阻塞
+    void log(LogLevel level, const char* format, ...) GTA6_PRINTF_FORMAT(3, 4) {
+        if (level < minimumLevel.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const std::uint32_t timeMs = elapsedMs();
+        if (level < LOG_LEVEL_WARN && !withinRateLimit(timeMs)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // 取得一個可寫的格子；緩衝區滿時直接丟棄
+        std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[position & (CAPACITY - 1)];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->message.level = static_cast<std::uint8_t>(level);
+        slot->message.timeMs = timeMs;
+        va_list arguments;
+        va_start(arguments, format);
+        std::vsnprintf(slot->message.text, MESSAGE_SIZE, format, arguments);
+        va_end(arguments);
+        accepted.fetch_add(1, std::memory_order_relaxed);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    // 等背景執行緒寫完目前已排入的訊息，例如在直接輸出到 std::cout 之前
+    void flush() {
+        const std::uint64_t target = accepted.load(std::memory_order_relaxed);
+        while (written.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+#if GTA6_LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(...) Logger::get().log(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+#if GTA6_LOG_MIN_LEVEL <= 1
+#define LOG_INFO(...) Logger::get().log(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+#if GTA6_LOG_MIN_LEVEL <= 2
+#define LOG_WARN(...) Logger::get().log(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+#define LOG_ERROR(...) Logger::get().log(LOG_LEVEL_ERROR, __VA_ARGS__)
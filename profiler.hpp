@@ -0,0 +1,397 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Text.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 效能量測：以 PROFILE_SCOPE 標記的區段每幀累計耗時，加上幀時間百分位數與 draw call 數量。
+// 停用時每個區段只多一次旗標判斷；啟用追蹤時另外記錄每一次區段執行，
+// 結束時寫成 CSV 或 Chrome trace（副檔名 .json，可用 chrome://tracing 或 Perfetto 開啟）。
+// 每個執行緒使用自己的 Profiler：預設都是主要實例，其他執行緒以 setCurrent() 指定；
+// 區段編號在所有實例間共用，時間以同一個起點計算，追蹤檔可以合併
+class Profiler {
+public:
+    struct Section {
+        const char* name;
+        double frameMs = 0.0;     // 目前這一幀累計
+        double lastMs = 0.0;      // 上一幀
+        double averageMs = 0.0;   // 平滑後的平均，用於顯示
+        unsigned int calls = 0;   // 上一幀執行次數
+        unsigned int frameCalls = 0;
+    };
+
+private:
+    using ProfileClock = std::chrono::steady_clock;
+
+    struct TraceEvent {
+        int section;
+        int depth;
+        std::uint32_t frame;
+        double startUs;
+        double durationUs;
+    };
+
+    static const std::size_t FRAME_HISTORY = 600;         // 百分位數取最近幾幀
+    static const std::size_t MAX_TRACE_EVENTS = 4000000;  // 追蹤事件上限，避免長時間執行耗盡記憶體
+
+    bool enabled = false;
+    bool tracing = false;
+    double frameStartUs = 0.0;
+    std::uint32_t frameIndex = 0;
+    int depth = 0;
+    std::vector<Section> sections;
+    std::vector<float> frameTimes;  // 環狀緩衝區（毫秒）
+    std::size_t nextFrameTime = 0;
+    unsigned int frameDrawCalls = 0;
+    unsigned int lastDrawCalls = 0;
+    std::vector<std::pair<const char*, double>> counters;  // 由遊戲回報的數值，例如配置次數
+    std::vector<TraceEvent> trace;
+
+    // 所有實例共用的時間起點與區段名稱
+    static ProfileClock::time_point origin() {
+        static const ProfileClock::time_point start = ProfileClock::now();
+        return start;
+    }
+
+    static std::vector<const char*>& sectionNames() {
+        static std::vector<const char*> names;
+        return names;
+    }
+
+    static std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static Profiler*& current() {
+        static Profiler mainInstance;
+        static thread_local Profiler* instance = &mainInstance;
+        return instance;
+    }
+
+    Section& getSection(int id) {
+        if (static_cast<std::size_t>(id) >= sections.size()) {
+            std::lock_guard<std::mutex> lock(registryMutex());
+            const std::vector<const char*>& names = sectionNames();
+            while (sections.size() < names.size()) {
+                Section section;
+                section.name = names[sections.size()];
+                sections.push_back(section);
+            }
+        }
+        return sections[id];
+    }
+
+public:
+    // 目前執行緒使用的實例
+    static Profiler& get() {
+        return *current();
+    }
+
+    // 讓目前執行緒改用 profiler（例如繪製執行緒自己的實例）
+    static void setCurrent(Profiler& profiler) {
+        current() = &profiler;
+    }
+
+    void setEnabled(bool enable) {
+        enabled = enable;
+    }
+
+    bool isEnabled() const {
+        return enabled;
+    }
+
+    // 開始記錄追蹤事件（同時啟用量測）
+    void startTrace() {
+        enabled = true;
+        tracing = true;
+        trace.reserve(1 << 16);
+    }
+
+    bool isTracing() const {
+        return tracing;
+    }
+
+    // 以名稱登記區段並回傳編號；同名回傳同一個編號
+    static int registerSection(const char* name) {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        std::vector<const char*>& names = sectionNames();
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (std::strcmp(names[i], name) == 0) {
+                return static_cast<int>(i);
+            }
+        }
+        names.push_back(name);
+        return static_cast<int>(names.size() - 1);
+    }
+
+    // 自第一次使用以來經過的微秒數
+    double now() const {
+        return std::chrono::duration<double, std::micro>(ProfileClock::now() - origin()).count();
+    }
+
+    void beginFrame() {
+        if (enabled) {
+            frameStartUs = now();
+        }
+    }
+
+    void endFrame() {
+        if (!enabled) {
+            return;
+        }
+        const float frameMs = static_cast<float>((now() - frameStartUs) / 1000.0);
+        if (frameTimes.size() < FRAME_HISTORY) {
+            frameTimes.push_back(frameMs);
+        } else {
+            frameTimes[nextFrameTime] = frameMs;
+        }
+        nextFrameTime = (nextFrameTime + 1) % FRAME_HISTORY;
+
+        for (auto& section : sections) {
+            section.lastMs = section.frameMs;
+            section.calls = section.frameCalls;
+            section.averageMs += (section.frameMs - section.averageMs) * 0.05;
+            section.frameMs = 0.0;
+            section.frameCalls = 0;
+        }
+        lastDrawCalls = frameDrawCalls;
+        frameDrawCalls = 0;
+        ++frameIndex;
+    }
+
+    // ProfileScope 進出時呼叫
+    int enterScope() {
+        return depth++;
+    }
+
+    void exitScope(int section, int scopeDepth, double startUs, double endUs) {
+        depth = scopeDepth;
+        Section& entry = getSection(section);
+        entry.frameMs += (endUs - startUs) / 1000.0;
+        ++entry.frameCalls;
+        if (tracing && trace.size() < MAX_TRACE_EVENTS) {
+            trace.push_back({section, scopeDepth, frameIndex, startUs, endUs - startUs});
+        }
+    }
+
+    // 繪製並計算 draw call；一個 SpriteBatch 或 sf::Text 各算一次
+    void draw(sf::RenderTarget& target, const sf::Drawable& drawable,
+              const sf::RenderStates& states = sf::RenderStates::Default) {
+        target.draw(drawable, states);
+        ++frameDrawCalls;
+    }
+
+    // 設定一個顯示在覆蓋層的數值；name 必須在整個執行期間有效（例如字串常數）
+    void setCounter(const char* name, double value) {
+        for (auto& counter : counters) {
+            if (std::strcmp(counter.first, name) == 0) {
+                counter.second = value;
+                return;
+            }
+        }
+        counters.emplace_back(name, value);
+    }
+
+    const std::vector<std::pair<const char*, double>>& getCounters() const {
+        return counters;
+    }
+
+    // 最近 FRAME_HISTORY 幀的幀時間百分位數（percentile 介於 0 與 100）
+    float getFrameTimePercentile(float percentile) const {
+        if (frameTimes.empty()) {
+            return 0.f;
+        }
+        std::vector<float> sorted(frameTimes);
+        const std::size_t index = std::min(sorted.size() - 1,
+                                           static_cast<std::size_t>(percentile / 100.f * (sorted.size() - 1) + 0.5f));
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+
+    const std::vector<Section>& getSections() const {
+        return sections;
+    }
+
+    unsigned int getDrawCalls() const {
+        return lastDrawCalls;
+    }
+
+    std::uint32_t getFrameCount() const {
+        return frameIndex;
+    }
+
+    // 寫出追蹤事件：.json 為 Chrome trace 格式，其他副檔名為 CSV
+    bool writeTrace(const std::string& path) const {
+        return writeTrace(path, std::vector<const Profiler*>(1, this));
+    }
+
+    // 合併多個實例（例如模擬與繪製執行緒）的追蹤事件，第 i 個實例記為執行緒 i + 1
+    static bool writeTrace(const std::string& path, const std::vector<const Profiler*>& profilers) {
+        std::FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        const bool chromeTrace = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+        if (chromeTrace) {
+            std::fprintf(file, "{\"traceEvents\":[\n");
+        } else {
+            std::fprintf(file, "frame,section,depth,start_us,duration_us,thread\n");
+        }
+        bool first = true;
+        for (std::size_t thread = 0; thread < profilers.size(); ++thread) {
+            const Profiler& profiler = *profilers[thread];
+            for (const auto& event : profiler.trace) {
+                const char* name = profiler.sections[event.section].name;
+                if (chromeTrace) {
+                    std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                                 "\"args\":{\"frame\":%u}}\n",
+                                 first ? "" : ",", name, static_cast<unsigned int>(thread + 1), event.startUs,
+                                 event.durationUs, static_cast<unsigned int>(event.frame));
+                } else {
+                    std::fprintf(file, "%u,%s,%d,%.3f,%.3f,%u\n", static_cast<unsigned int>(event.frame), name,
+                                 event.depth, event.startUs, event.durationUs, static_cast<unsigned int>(thread + 1));
+                }
+                first = false;
+            }
+        }
+        if (chromeTrace) {
+            std::fprintf(file, "],\"displayTimeUnit\":\"ms\"}\n");
+        }
+        const bool ok = std::ferror(file) == 0;
+        std::fclose(file);
+        return ok;
+    }
+};
+
+// 在建構到解構之間計時，結果累計到指定區段
+class ProfileScope {
+private:
+    int section;
+    int depth;
+    double startUs;
+
+public:
+    explicit ProfileScope(int sectionId) : section(sectionId), depth(-1), startUs(0.0) {
+        Profiler& profiler = Profiler::get();
+        if (profiler.isEnabled()) {
+            depth = profiler.enterScope();
+            startUs = profiler.now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (depth >= 0) {
+            Profiler& profiler = Profiler::get();
+            profiler.exitScope(section, depth, startUs, profiler.now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_JOIN_INNER(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN_INNER(a, b)
+
+// 量測所在區塊的耗時；區段編號只在第一次執行時登記
+#define PROFILE_SCOPE(name)                                                                       \
+    static const int PROFILE_JOIN(profileSection, __LINE__) = Profiler::registerSection(name);     \
+    ProfileScope PROFILE_JOIN(profileScope, __LINE__)(PROFILE_JOIN(profileSection, __LINE__))
+
+// 畫面左下角的效能資訊：幀時間百分位數、draw call 數量與各區段耗時。
+// 文字每隔幾幀才重建一次，避免覆蓋層本身成為負擔
+class ProfilerOverlay {
+private:
+    static const unsigned int REFRESH_FRAMES = 15;
+
+    sf::Text text;
+    sf::RectangleShape background;
+    bool visible = false;
+    unsigned int framesSinceRefresh = REFRESH_FRAMES;
+
+    static void appendSections(std::string& content, const std::vector<Profiler::Section>& sections) {
+        char line[128];
+        for (const auto& section : sections) {
+            // 區段編號各執行緒共用，略過這個執行緒沒有用到的區段
+            if (section.calls == 0 && section.averageMs < 0.0005) {
+                continue;
+            }
+            std::snprintf(line, sizeof(line), "%-22s %7.3f ms  x%u\n", section.name, section.averageMs, section.calls);
+            content += line;
+        }
+    }
+
+    // 重建文字並貼齊畫面左下角
+    void refresh(const Profiler& profiler, const std::vector<Profiler::Section>* simulationSections,
+                 float targetHeight) {
+        char line[128];
+        std::string content;
+        std::snprintf(line, sizeof(line), "frame ms  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f\n",
+                      profiler.getFrameTimePercentile(50.f), profiler.getFrameTimePercentile(95.f),
+                      profiler.getFrameTimePercentile(99.f), profiler.getFrameTimePercentile(100.f));
+        content += line;
+        std::snprintf(line, sizeof(line), "draw calls %u\n", profiler.getDrawCalls());
+        content += line;
+        for (const auto& counter : profiler.getCounters()) {
+            std::snprintf(line, sizeof(line), "%s %.5g\n", counter.first, counter.second);
+            content += line;
+        }
+        appendSections(content, profiler.getSections());
+        if (simulationSections) {
+            content += "-- simulation --\n";
+            appendSections(content, *simulationSections);
+        }
+        text.setString(content);
+        const sf::FloatRect local = text.getLocalBounds();
+        text.setPosition(16.f, targetHeight - local.top - local.height - 16.f);
+        const sf::FloatRect bounds = text.getGlobalBounds();
+        background.setPosition(bounds.left - 6.f, bounds.top - 6.f);
+        background.setSize(sf::Vector2f(bounds.width + 12.f, bounds.height + 12.f));
+    }
+
+public:
+    explicit ProfilerOverlay(const sf::Font& font, unsigned int characterSize = 14) {
+        text.setFont(font);
+        text.setCharacterSize(characterSize);
+        text.setFillColor(sf::Color::White);
+        background.setFillColor(sf::Color(0, 0, 0, 180));
+    }
+
+    void toggle() {
+        visible = !visible;
+        framesSinceRefresh = REFRESH_FRAMES;
+    }
+
+    bool isVisible() const {
+        return visible;
+    }
+
+    // 不經過 Profiler::draw，覆蓋層本身不算進 draw call。
+    // simulationSections 為模擬執行緒的區段（由快照複製），與繪製區段分開列出
+    void draw(sf::RenderTarget& target, const Profiler& profiler,
+              const std::vector<Profiler::Section>* simulationSections = nullptr) {
+        if (!visible) {
+            return;
+        }
+        if (++framesSinceRefresh >= REFRESH_FRAMES) {
+            framesSinceRefresh = 0;
+            refresh(profiler, simulationSections, static_cast<float>(target.getSize().y));
+        }
+        target.draw(background);
+        target.draw(text);
+    }
+};
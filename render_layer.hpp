@@ -0,0 +1,93 @@
+#pragma once
+
+#include <SFML/Graphics/BlendMode.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// 快取圖層：很少改變的內容（遊戲區域邊界、血條、HUD 文字）畫進一張 sf::RenderTexture，
+// 之後每幀只以一個方塊貼上；呼叫 invalidate() 之後，下一次繪製才重新畫進材質。
+//
+// 材質內容是預乘 alpha（透明底色上畫半透明的字形邊緣），貼上時使用預乘的混合模式，
+// 邊緣才不會變暗。無法建立 RenderTexture 時（不支援 FBO 等）每幀直接畫到目標上
+class CachedLayer : public sf::Drawable {
+public:
+    typedef std::function<void(sf::RenderTarget&)> RenderFunction;
+
+private:
+    mutable sf::RenderTexture texture;
+    sf::Color clearColor;
+    RenderFunction render;
+    sf::Vertex quad[4];
+    bool cached = false;
+    mutable bool dirty = true;
+    mutable std::size_t redrawCount = 0;
+
+    void refresh() const {
+        if (!dirty) {
+            return;
+        }
+        texture.clear(clearColor);
+        render(texture);
+        texture.display();
+        dirty = false;
+        ++redrawCount;
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        if (!cached) {
+            if (clearColor.a != 0) {
+                sf::Vertex background[4];
+                for (int i = 0; i < 4; ++i) {
+                    background[i] = sf::Vertex(quad[i].position, clearColor);
+                }
+                target.draw(background, 4, sf::TriangleStrip, states);
+            }
+            render(target);
+            return;
+        }
+        refresh();
+        states.texture = &texture.getTexture();
+        states.blendMode = sf::BlendMode(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+        target.draw(quad, 4, sf::TriangleStrip, states);
+    }
+
+public:
+    // width × height 的圖層（通常與視窗相同），左上角貼在 (0, 0)；
+    // renderFunction 把圖層內容畫到傳入的目標上，底色為 background（預設透明）。
+    // 回傳是否能使用快取材質
+    bool create(unsigned int width, unsigned int height, RenderFunction renderFunction,
+                const sf::Color& background = sf::Color::Transparent) {
+        render = std::move(renderFunction);
+        clearColor = background;
+        cached = texture.create(width, height);
+        dirty = true;
+
+        const float w = static_cast<float>(width);
+        const float h = static_cast<float>(height);
+        quad[0] = sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Vector2f(0.f, 0.f));
+        quad[1] = sf::Vertex(sf::Vector2f(w, 0.f), sf::Vector2f(w, 0.f));
+        quad[2] = sf::Vertex(sf::Vector2f(0.f, h), sf::Vector2f(0.f, h));
+        quad[3] = sf::Vertex(sf::Vector2f(w, h), sf::Vector2f(w, h));
+        return cached;
+    }
+
+    // 內容改變，下一次繪製時重畫
+    void invalidate() {
+        dirty = true;
+    }
+
+    bool isCached() const {
+        return cached;
+    }
+
+    // 重畫進材質的次數（沒有快取時為 0）
+    std::size_t getRedrawCount() const {
+        return redrawCount;
+    }
+};
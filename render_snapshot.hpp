@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// 模擬執行緒與繪製執行緒之間的快照交換：模擬端寫完一份快照後發布，繪製端取用最新的一份。
+// 共三格：兩端各自擁有一格，中間一格以原子交換傳遞，雙方都不必等待對方。
+// 繪製端拿到的快照在下一次 acquire() 之前不會被改寫；沒有新快照時繼續使用手上那一份。
+// 格子會被重複使用，快照內的 vector 保留容量，暖機後發布不再配置記憶體
+template <typename Snapshot>
+class SnapshotExchange {
+private:
+    static const unsigned int INDEX_MASK = 3;
+    static const unsigned int FRESH = 4;  // 中間格是尚未被取走的新快照
+
+    Snapshot buffers[3];
+    std::atomic<unsigned int> middle{1};
+    unsigned int back = 0;   // 模擬端正在寫的格子
+    unsigned int front = 2;  // 繪製端正在讀的格子
+
+public:
+    // 模擬端：取得可寫入的快照（內容是較舊的快照，要全部覆寫）
+    Snapshot& beginWrite() {
+        return buffers[back];
+    }
+
+    // 模擬端：發布 beginWrite() 寫好的快照
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // 繪製端：有新快照時換過來，回傳目前持有的快照；isFresh 表示是否為新的一份
+    const Snapshot& acquire(bool* isFresh = nullptr) {
+        const bool fresh = (middle.load(std::memory_order_relaxed) & FRESH) != 0;
+        if (fresh) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        if (isFresh) {
+            *isFresh = fresh;
+        }
+        return buffers[front];
+    }
+};
+
+// 快照時間戳記（微秒），兩個執行緒使用同一個時鐘
+inline double snapshotClockUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 最近幾個樣本的百分位數，例如快照從產生到顯示的延遲
+class LatencyHistogram {
+private:
+    static const std::size_t HISTORY = 600;
+
+    std::vector<float> samples;  // 環狀緩衝區（毫秒）
+    std::size_t next = 0;
+    mutable std::vector<float> sorted;
+
+public:
+    void add(float milliseconds) {
+        if (samples.size() < HISTORY) {
+            samples.push_back(milliseconds);
+        } else {
+            samples[next] = milliseconds;
+        }
+        next = (next + 1) % HISTORY;
+    }
+
+    // percentile 介於 0 與 100
+    float getPercentile(float percentile) const {
+        if (samples.empty()) {
+            return 0.f;
+        }
+        sorted.assign(samples.begin(), samples.end());
+        const std::size_t index = std::min(sorted.size() - 1,
+                                           static_cast<std::size_t>(percentile / 100.f * (sorted.size() - 1) + 0.5f));
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    }
+};
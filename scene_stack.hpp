@@ -0,0 +1,127 @@
+#pragma once
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/Window/Event.hpp>
+#include <memory>
+#include <vector>
+
+// 畫面（遊戲進行中、暫停、商店、關卡畫面等）的共同介面。
+// 所有畫面都由 SceneStack 的同一個主迴圈驅動，只有堆疊頂端的畫面收到事件與更新
+class Scene {
+private:
+    bool dirty = true;
+
+public:
+    virtual ~Scene() = default;
+
+    virtual void handleEvent(const sf::Event& event) = 0;
+
+    // 主迴圈每一輪呼叫一次（遊戲進行中在這裡推進模擬）
+    virtual void update() {}
+
+    virtual void draw(sf::RenderTarget& target) = 0;
+
+    // 上面的畫面移除、重新回到頂端時呼叫
+    virtual void resume() {}
+
+    // 每一輪都要重畫的畫面；靜態畫面只在 invalidate() 之後重畫
+    virtual bool isAnimated() const {
+        return false;
+    }
+
+    // 畫面內容改變，下一輪重畫
+    void invalidate() {
+        dirty = true;
+    }
+
+    // 取出並清除重畫旗標
+    bool takeDirty() {
+        const bool wasDirty = dirty;
+        dirty = false;
+        return wasDirty;
+    }
+};
+
+// 畫面堆疊與唯一的主迴圈：頂端的畫面處理事件與更新，只繪製頂端的畫面。
+// 靜態畫面沒有改變時不繪製，主迴圈以 IDLE_POLL_INTERVAL 睡眠等待事件，
+// 另外每 IDLE_REDRAW_INTERVAL 重畫一次（視窗被遮蓋後恢復內容）
+class SceneStack {
+private:
+    std::vector<std::unique_ptr<Scene>> scenes;
+    std::vector<std::unique_ptr<Scene>> removed;  // 目前這一輪移除的畫面，可能還在自己的事件處理中
+    bool changed = true;
+    bool quitting = false;
+
+public:
+    static constexpr float IDLE_POLL_INTERVAL = 0.01f;  // 秒
+    static constexpr float IDLE_REDRAW_INTERVAL = 0.5f;
+
+    // 放到頂端；可以在畫面的事件處理或更新中呼叫
+    Scene& push(std::unique_ptr<Scene> scene) {
+        scenes.push_back(std::move(scene));
+        changed = true;
+        return *scenes.back();
+    }
+
+    // 移除頂端的畫面（延到這一輪結束才釋放），下面的畫面收到 resume()
+    void pop() {
+        if (scenes.empty()) {
+            return;
+        }
+        removed.push_back(std::move(scenes.back()));
+        scenes.pop_back();
+        changed = true;
+        if (!scenes.empty()) {
+            scenes.back()->resume();
+        }
+    }
+
+    // 結束主迴圈
+    void quit() {
+        quitting = true;
+    }
+
+    bool isEmpty() const {
+        return scenes.empty();
+    }
+
+    // 主迴圈：直到視窗關閉、堆疊清空或 quit()
+    void run(sf::RenderWindow& window) {
+        sf::Clock idleClock;
+        while (window.isOpen() && !scenes.empty() && !quitting) {
+            sf::Event event;
+            while (window.pollEvent(event) && !scenes.empty() && !quitting) {
+                if (event.type == sf::Event::Closed) {
+                    window.close();
+                    break;
+                }
+                if (event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus) {
+                    changed = true;
+                }
+                scenes.back()->handleEvent(event);
+            }
+            if (!window.isOpen() || scenes.empty() || quitting) {
+                break;
+            }
+            scenes.back()->update();
+            removed.clear();
+            if (scenes.empty() || quitting) {
+                break;
+            }
+
+            Scene& top = *scenes.back();
+            const bool dirty = top.takeDirty();
+            if (top.isAnimated() || dirty || changed || idleClock.getElapsedTime().asSeconds() >= IDLE_REDRAW_INTERVAL) {
+                top.draw(window);
+                window.display();
+                changed = false;
+                idleClock.restart();
+            } else {
+                sf::sleep(sf::seconds(IDLE_POLL_INTERVAL));
+            }
+        }
+        removed.clear();
+    }
+};
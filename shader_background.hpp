@@ -0,0 +1,162 @@
+#pragma once
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include "asset_loader.hpp"
+#include "asset_pack.hpp"
+#include "background_animation.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 以 shader 選幀的背景動畫：所有幀一次上傳到同一張材質（依格子排列），
+// fragment shader 依時間 uniform 算出目前的幀與格子位置。播放時每幀只設定一個 uniform，
+// 以一次繪製（一個方塊）畫出背景，不換材質也不改 sprite。
+//
+// 與 AtlasBackground 一樣整段動畫都留在顯示記憶體中，只用於不超過預算的動畫；
+// 由 createBackgroundAnimation() 在要求時使用，不支援 shader、幀放不進一張材質等情況改用圖集
+class ShaderBackground : public BackgroundAnimation {
+private:
+    // gl_TexCoord[0] 是第 0 格的座標（沒有綁定 states.texture，不經過材質矩陣）
+    static constexpr const char* FRAGMENT_SHADER = R"(
+uniform sampler2D sheet;
+uniform float time;        // 播放時間（秒，已對循環長度取餘數）
+uniform float frameTime;
+uniform float frameCount;
+uniform float columns;
+uniform vec2 cellSize;     // 一格在材質座標中的大小
+
+void main() {
+    float frame = mod(floor(time / frameTime), frameCount);
+    float row = floor((frame + 0.5) / columns);
+    vec2 cell = vec2(frame - row * columns, row);
+    gl_FragColor = texture2D(sheet, gl_TexCoord[0].xy + cell * cellSize) * gl_Color;
+}
+)";
+
+    std::size_t frameCount = 0;
+    float frameTime = 0.f;
+    float playTime = 0.f;
+    sf::Vector2u frameSize;
+    unsigned int columns = 1;
+    sf::Texture sheet;
+    sf::Shader shader;
+    sf::VertexArray quad{sf::TriangleStrip, 4};
+    std::unique_ptr<AssetLoader> loader;  // 其餘幀的非同步解碼，全部上傳後釋放
+    std::size_t decodedCount = 0;
+    std::size_t packMisses = 0;
+
+    void upload(const DecodedImage& decoded, std::size_t index) {
+        ++decodedCount;
+        if (!decoded.fromPack && decoded.loaded) {
+            ++packMisses;
+        }
+        // 載入失敗或大小不同的幀留空
+        if (decoded.loaded && decoded.getSize() == frameSize) {
+            sheet.update(decoded.getPixels(), frameSize.x, frameSize.y,
+                         static_cast<unsigned int>(index % columns) * frameSize.x,
+                         static_cast<unsigned int>(index / columns) * frameSize.y);
+        }
+    }
+
+    void uploadPending() {
+        DecodedImage decoded;
+        for (std::size_t i = 0; i < UPLOADS_PER_UPDATE && loader->poll(decoded); ++i) {
+            upload(decoded, std::stoul(decoded.name));
+        }
+        if (loader->isFinished()) {
+            loader.reset();
+        }
+    }
+
+public:
+    // framePaths 為完整路徑（依播放順序，每一幀大小相同），size 為繪製的大小。
+    // 同步解碼第一幀以決定格子大小，其餘幀在背景解碼、載入完成前停在第一幀。
+    // 不支援 shader、幀放不進 maxSheetSize（再受顯示卡上限限制）或建立材質失敗時回傳 false
+    bool create(const std::vector<std::string>& framePaths, float frameDuration, const sf::Vector2f& size,
+                const AssetPack* pack = nullptr, unsigned int maxSheetSize = 8192) {
+        if (framePaths.empty() || !sf::Shader::isAvailable()) {
+            return false;
+        }
+        DecodedImage first;
+        first.path = framePaths[0];
+        decodeAsset(pack, first);
+        if (!first.loaded) {
+            return false;
+        }
+
+        frameCount = framePaths.size();
+        frameTime = frameDuration;
+        frameSize = first.getSize();
+        const unsigned int maxSize = std::min(maxSheetSize, sf::Texture::getMaximumSize());
+        if (frameSize.x == 0 || frameSize.y == 0 || frameSize.x > maxSize || frameSize.y > maxSize) {
+            return false;
+        }
+        columns = static_cast<unsigned int>(std::min<std::size_t>(frameCount, maxSize / frameSize.x));
+        const unsigned int rows = static_cast<unsigned int>((frameCount + columns - 1) / columns);
+        if (rows > maxSize / frameSize.y || !sheet.create(columns * frameSize.x, rows * frameSize.y) ||
+            !shader.loadFromMemory(FRAGMENT_SHADER, sf::Shader::Fragment)) {
+            return false;
+        }
+
+        const sf::Vector2f cellSize(static_cast<float>(frameSize.x) / sheet.getSize().x,
+                                    static_cast<float>(frameSize.y) / sheet.getSize().y);
+        shader.setUniform("sheet", sheet);
+        shader.setUniform("time", 0.f);
+        shader.setUniform("frameTime", frameTime);
+        shader.setUniform("frameCount", static_cast<float>(frameCount));
+        shader.setUniform("columns", static_cast<float>(columns));
+        shader.setUniform("cellSize", cellSize);
+
+        quad[0] = sf::Vertex(sf::Vector2f(0.f, 0.f), sf::Vector2f(0.f, 0.f));
+        quad[1] = sf::Vertex(sf::Vector2f(size.x, 0.f), sf::Vector2f(cellSize.x, 0.f));
+        quad[2] = sf::Vertex(sf::Vector2f(0.f, size.y), sf::Vector2f(0.f, cellSize.y));
+        quad[3] = sf::Vertex(sf::Vector2f(size.x, size.y), cellSize);
+
+        upload(first, 0);
+        first = DecodedImage();
+        if (frameCount > 1) {
+            loader.reset(new AssetLoader(1, pack));
+            for (std::size_t i = 1; i < frameCount; ++i) {
+                loader->request(std::to_string(i), framePaths[i]);
+            }
+        }
+        return true;
+    }
+
+    void update(float deltaTime) override {
+        playTime = std::fmod(playTime + deltaTime, frameTime * frameCount);
+        if (loader) {
+            uploadPending();
+        }
+        shader.setUniform("time", loader ? 0.f : playTime);
+    }
+
+    void draw(sf::RenderTarget& target) override {
+        sf::RenderStates states;
+        states.shader = &shader;
+        Profiler::get().draw(target, quad, states);
+    }
+
+    const char* getModeName() const override {
+        return "shader";
+    }
+
+    std::size_t getFrameCount() const override {
+        return frameCount;
+    }
+
+    std::size_t getDecodedCount() const override {
+        return decodedCount;
+    }
+
+    std::size_t getPackMissCount() const override {
+        return packMisses;
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include "texture_atlas.hpp"
+#include <cmath>
+#include <string>
+
+// 程式產生的實體圖案（白色，繪製時以頂點顏色上色）。放進圖集後子彈、敵人與玩家共用同一張材質，
+// 以同一個 SpriteBatch 繪製，不必把圓形拆成幾十個三角形
+const std::string SHAPE_SQUARE = "shape/square";
+const std::string SHAPE_CIRCLE = "shape/circle";
+
+// 每個圖案外圍都有 1 像素的邊（方塊為白色、圓形為透明），平滑取樣時邊緣不會混到圖集中的其他圖片
+const int SHAPE_BORDER = 1;
+
+// 直徑 diameter 的白色實心圓，邊緣以 4×4 取樣的覆蓋率做反鋸齒
+inline sf::Image makeCircleImage(unsigned int diameter) {
+    const unsigned int size = diameter + 2 * SHAPE_BORDER;
+    sf::Image image;
+    image.create(size, size, sf::Color(255, 255, 255, 0));
+
+    const float center = size / 2.f;
+    const float radiusSquared = (diameter / 2.f) * (diameter / 2.f);
+    const int samples = 4;
+    for (unsigned int y = 0; y < size; ++y) {
+        for (unsigned int x = 0; x < size; ++x) {
+            int inside = 0;
+            for (int sy = 0; sy < samples; ++sy) {
+                for (int sx = 0; sx < samples; ++sx) {
+                    const float dx = x + (sx + 0.5f) / samples - center;
+                    const float dy = y + (sy + 0.5f) / samples - center;
+                    inside += dx * dx + dy * dy <= radiusSquared;
+                }
+            }
+            const int alpha = static_cast<int>(std::lround(255.f * inside / (samples * samples)));
+            image.setPixel(x, y, sf::Color(255, 255, 255, static_cast<sf::Uint8>(alpha)));
+        }
+    }
+    return image;
+}
+
+// 加入方塊與直徑 circleDiameter 的圓形（之後由呼叫者 build()）；圓形以接近這個大小繪製時最清楚
+inline void addShapeSprites(TextureAtlas& atlas, unsigned int circleDiameter) {
+    sf::Image square;
+    square.create(2 + 2 * SHAPE_BORDER, 2 + 2 * SHAPE_BORDER, sf::Color::White);
+    atlas.add(SHAPE_SQUARE, square);
+    atlas.add(SHAPE_CIRCLE, makeCircleImage(circleDiameter));
+}
+
+// 圖案在圖集中的取樣範圍（不含外圍的邊），傳給 SpriteBatch::addQuad
+inline sf::FloatRect getShapeTexRect(const TextureAtlas& atlas, const std::string& shape) {
+    const sf::IntRect rect = atlas.getRegion(shape).rect;
+    return sf::FloatRect(static_cast<float>(rect.left + SHAPE_BORDER), static_cast<float>(rect.top + SHAPE_BORDER),
+                         static_cast<float>(rect.width - 2 * SHAPE_BORDER),
+                         static_cast<float>(rect.height - 2 * SHAPE_BORDER));
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// 實體陣列的向量化核心：位置推進（values += rates * scale）與
+// 一個 AABB 對 8 個 AABB 的重疊測試。執行期依 CPU 選擇 AVX2、SSE2、NEON 或純量版本，
+// 也可以用環境變數 GTA6_SIMD=scalar|sse2|avx2|neon 或 setSimdLevel() 指定（不能超過 CPU 支援的等級）。
+//
+// 所有版本都以分開捨入的乘法與加法計算，比較也與純量版本相同，結果逐位元一致，切換等級不影響重播。
+// 編譯器預設會把 a += b * c 合併成 FMA（Clang 的 -ffp-contract=on、GCC 的 -ffp-contract=fast，
+// 在有 FMA 的目標上，包括所有 arm64），所以乘積都經過 GTA6_FP_BARRIER 才相加
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GTA6_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define GTA6_TARGET_AVX2
+#else
+#define GTA6_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define GTA6_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// 讓 value 必須先以目前的型別存在（已捨入），編譯器看不到它來自乘法，無法與之後的加法合併成 FMA。
+// MSVC 預設不合併（/fp:contract 才會），不需要
+#if defined(__GNUC__) || defined(__clang__)
+#if GTA6_SIMD_X86
+#define GTA6_FP_BARRIER(value) __asm__("" : "+x"(value))
+#elif GTA6_SIMD_NEON
+#define GTA6_FP_BARRIER(value) __asm__("" : "+w"(value))
+#else
+#define GTA6_FP_BARRIER(value) __asm__("" : "+m"(value))
+#endif
+#else
+#define GTA6_FP_BARRIER(value) ((void)0)
+#endif
+
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_SSE2 = 1,
+    SIMD_AVX2 = 2,
+    SIMD_NEON = 3,
+};
+
+// 重疊測試的 AABB，右邊與下邊先算好
+struct SimdBox {
+    float left, top, right, bottom;
+
+    SimdBox(float x, float y, float w, float h) : left(x), top(y), right(x + w), bottom(y + h) {}
+};
+
+struct SimdKernels {
+    SimdLevel level;
+    const char* name;
+    // values[i] += rates[i] * scale
+    void (*addScaled)(float* values, const float* rates, std::size_t count, float scale);
+    // box 與 (x, y, w, h)[0..8) 的重疊遮罩，第 k 位元表示第 k 個重疊；8 個元素都必須可讀取
+    std::uint32_t (*overlapMask8)(const SimdBox& box, const float* x, const float* y, const float* w, const float* h);
+};
+
+// 與 aabbOverlap 相同的判定（邊緣相接不算重疊）
+inline bool simdBoxOverlaps(const SimdBox& box, float x, float y, float w, float h) {
+    return box.left < x + w && x < box.right && box.top < y + h && y < box.bottom;
+}
+
+inline unsigned int lowestSetBit(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+
+namespace simd_detail {
+
+inline void addScaledScalar(float* values, const float* rates, std::size_t count, float scale) {
+    for (std::size_t i = 0; i < count; ++i) {
+        float delta = rates[i] * scale;
+        GTA6_FP_BARRIER(delta);
+        values[i] += delta;
+    }
+}
+
+inline std::uint32_t overlapMask8Scalar(const SimdBox& box, const float* x, const float* y, const float* w,
+                                        const float* h) {
+    std::uint32_t mask = 0;
+    for (unsigned int k = 0; k < 8; ++k) {
+        mask |= static_cast<std::uint32_t>(simdBoxOverlaps(box, x[k], y[k], w[k], h[k])) << k;
+    }
+    return mask;
+}
+
+#if GTA6_SIMD_X86
+inline void addScaledSse2(float* values, const float* rates, std::size_t count, float scale) {
+    const __m128 factor = _mm_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 delta = _mm_mul_ps(_mm_loadu_ps(rates + i), factor);
+        GTA6_FP_BARRIER(delta);
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), delta));
+    }
+    addScaledScalar(values + i, rates + i, count - i, scale);
+}
+
+inline std::uint32_t overlapMask4Sse2(const SimdBox& box, const float* x, const float* y, const float* w,
+                                      const float* h) {
+    const __m128 bx = _mm_loadu_ps(x);
+    const __m128 by = _mm_loadu_ps(y);
+    __m128 hit = _mm_cmplt_ps(_mm_set1_ps(box.left), _mm_add_ps(bx, _mm_loadu_ps(w)));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(bx, _mm_set1_ps(box.right)));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(_mm_set1_ps(box.top), _mm_add_ps(by, _mm_loadu_ps(h))));
+    hit = _mm_and_ps(hit, _mm_cmplt_ps(by, _mm_set1_ps(box.bottom)));
+    return static_cast<std::uint32_t>(_mm_movemask_ps(hit));
+}
+
+inline std::uint32_t overlapMask8Sse2(const SimdBox& box, const float* x, const float* y, const float* w,
+                                      const float* h) {
+    return overlapMask4Sse2(box, x, y, w, h) | (overlapMask4Sse2(box, x + 4, y + 4, w + 4, h + 4) << 4);
+}
+
+GTA6_TARGET_AVX2 inline void addScaledAvx2(float* values, const float* rates, std::size_t count, float scale) {
+    const __m256 factor = _mm256_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 delta = _mm256_mul_ps(_mm256_loadu_ps(rates + i), factor);
+        GTA6_FP_BARRIER(delta);
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), delta));
+    }
+    addScaledScalar(values + i, rates + i, count - i, scale);
+}
+
+GTA6_TARGET_AVX2 inline std::uint32_t overlapMask8Avx2(const SimdBox& box, const float* x, const float* y,
+                                                       const float* w, const float* h) {
+    const __m256 bx = _mm256_loadu_ps(x);
+    const __m256 by = _mm256_loadu_ps(y);
+    __m256 hit = _mm256_cmp_ps(_mm256_set1_ps(box.left), _mm256_add_ps(bx, _mm256_loadu_ps(w)), _CMP_LT_OQ);
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(bx, _mm256_set1_ps(box.right), _CMP_LT_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_set1_ps(box.top), _mm256_add_ps(by, _mm256_loadu_ps(h)), _CMP_LT_OQ));
+    hit = _mm256_and_ps(hit, _mm256_cmp_ps(by, _mm256_set1_ps(box.bottom), _CMP_LT_OQ));
+    return static_cast<std::uint32_t>(_mm256_movemask_ps(hit));
+}
+
+inline bool cpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesAvx && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+#if GTA6_SIMD_NEON
+inline void addScaledNeon(float* values, const float* rates, std::size_t count, float scale) {
+    const float32x4_t factor = vdupq_n_f32(scale);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t delta = vmulq_f32(vld1q_f32(rates + i), factor);
+        GTA6_FP_BARRIER(delta);
+        vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), delta));
+    }
+    addScaledScalar(values + i, rates + i, count - i, scale);
+}
+
+inline std::uint32_t overlapMask4Neon(const SimdBox& box, const float* x, const float* y, const float* w,
+                                      const float* h) {
+    static const std::uint32_t laneBits[4] = {1, 2, 4, 8};
+    const float32x4_t bx = vld1q_f32(x);
+    const float32x4_t by = vld1q_f32(y);
+    uint32x4_t hit = vcltq_f32(vdupq_n_f32(box.left), vaddq_f32(bx, vld1q_f32(w)));
+    hit = vandq_u32(hit, vcltq_f32(bx, vdupq_n_f32(box.right)));
+    hit = vandq_u32(hit, vcltq_f32(vdupq_n_f32(box.top), vaddq_f32(by, vld1q_f32(h))));
+    hit = vandq_u32(hit, vcltq_f32(by, vdupq_n_f32(box.bottom)));
+    return vaddvq_u32(vandq_u32(hit, vld1q_u32(laneBits)));
+}
+
+inline std::uint32_t overlapMask8Neon(const SimdBox& box, const float* x, const float* y, const float* w,
+                                      const float* h) {
+    return overlapMask4Neon(box, x, y, w, h) | (overlapMask4Neon(box, x + 4, y + 4, w + 4, h + 4) << 4);
+}
+#endif
+
+inline SimdLevel detectSimdLevel() {
+#if GTA6_SIMD_X86
+    return cpuSupportsAvx2() ? SIMD_AVX2 : SIMD_SSE2;
+#elif GTA6_SIMD_NEON
+    return SIMD_NEON;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+inline SimdKernels makeKernels(SimdLevel level) {
+    switch (level) {
+#if GTA6_SIMD_X86
+    case SIMD_AVX2:
+        return {SIMD_AVX2, "avx2", &addScaledAvx2, &overlapMask8Avx2};
+    case SIMD_SSE2:
+        return {SIMD_SSE2, "sse2", &addScaledSse2, &overlapMask8Sse2};
+#endif
+#if GTA6_SIMD_NEON
+    case SIMD_NEON:
+        return {SIMD_NEON, "neon", &addScaledNeon, &overlapMask8Neon};
+#endif
+    default:
+        return {SIMD_SCALAR, "scalar", &addScaledScalar, &overlapMask8Scalar};
+    }
+}
+
+// 這個執行檔與 CPU 能否使用 level（純量版本永遠可用；x86 上 AVX2 包含 SSE2）
+inline bool isSupported(SimdLevel level) {
+    return makeKernels(level).level == level && (level == SIMD_SCALAR || level <= detectSimdLevel());
+}
+
+// 目前使用的核心；第一次使用時依 CPU 與 GTA6_SIMD 決定
+inline SimdKernels& currentKernels() {
+    static SimdKernels kernels = [] {
+        SimdLevel level = detectSimdLevel();
+        const char* const names[] = {"scalar", "sse2", "avx2", "neon"};
+        const char* requested = std::getenv("GTA6_SIMD");
+        for (int candidate = 0; requested && candidate < 4; ++candidate) {
+            if (std::strcmp(requested, names[candidate]) == 0 && isSupported(static_cast<SimdLevel>(candidate))) {
+                level = static_cast<SimdLevel>(candidate);
+            }
+        }
+        return makeKernels(level);
+    }();
+    return kernels;
+}
+
+}  // namespace simd_detail
+
+inline const SimdKernels& simdKernels() {
+    return simd_detail::currentKernels();
+}
+
+// 指定使用的等級（在啟動其他執行緒之前呼叫）；不支援時維持原本的等級並回傳 false
+inline bool setSimdLevel(SimdLevel level) {
+    if (!simd_detail::isSupported(level)) {
+        return false;
+    }
+    simd_detail::currentKernels() = simd_detail::makeKernels(level);
+    return true;
+}
+
+// 依索引順序對 [0, count) 中與 box 重疊的元素呼叫 visit(index)；visit 回傳 false 時停止。
+// 每次測試 8 個，剩下不足 8 個的以純量判定
+template <typename Visitor>
+void forEachOverlap(const SimdBox& box, const float* x, const float* y, const float* w, const float* h,
+                    std::size_t count, Visitor&& visit) {
+    const SimdKernels& kernels = simdKernels();
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        std::uint32_t mask = kernels.overlapMask8(box, x + i, y + i, w + i, h + i);
+        while (mask != 0) {
+            if (!visit(i + lowestSetBit(mask))) {
+                return;
+            }
+            mask &= mask - 1;
+        }
+    }
+    for (; i < count; ++i) {
+        if (simdBoxOverlaps(box, x[i], y[i], w[i], h[i]) && !visit(i)) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "entity_store.hpp"
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 均勻網格空間雜湊（broad-phase）：每個 tick 以計數排序重建，
+// 查詢只檢查 AABB 涵蓋到的格子，碰撞成本隨實體數量線性成長。
+// 重建時把每格實體的 AABB 依格子順序複製成連續陣列，findFirstOverlap() 一次比對 8 個
+class SpatialGrid {
+private:
+    float originX, originY;
+    float cellSize;
+    int columns, rows;
+    std::vector<int> cellStart;    // 每格在 cellEntries 中的起點（長度為格數 + 1）
+    std::vector<int> cellEntries;  // 依格子排序後的實體索引
+    std::vector<float> entryX, entryY, entryWidth, entryHeight;  // 與 cellEntries 對齊的 AABB，尾端多留 8 格
+    std::vector<int> cursor;
+
+    int clampColumn(float worldX) const {
+        int column = static_cast<int>((worldX - originX) / cellSize);
+        return std::min(std::max(column, 0), columns - 1);
+    }
+
+    int clampRow(float worldY) const {
+        int row = static_cast<int>((worldY - originY) / cellSize);
+        return std::min(std::max(row, 0), rows - 1);
+    }
+
+    // 對 AABB 涵蓋的每一格呼叫 visit(cellIndex)，超出範圍的部分歸到邊緣格
+    template <typename CellVisitor>
+    void forEachCell(float x, float y, float w, float h, CellVisitor&& visit) const {
+        const int column0 = clampColumn(x);
+        const int column1 = clampColumn(x + w);
+        const int row0 = clampRow(y);
+        const int row1 = clampRow(y + h);
+        for (int row = row0; row <= row1; ++row) {
+            for (int column = column0; column <= column1; ++column) {
+                visit(row * columns + column);
+            }
+        }
+    }
+
+public:
+    SpatialGrid(float left, float top, float width, float height, float cell)
+        : originX(left), originY(top), cellSize(cell),
+          columns(std::max(1, static_cast<int>(width / cell) + 1)),
+          rows(std::max(1, static_cast<int>(height / cell) + 1)) {
+        cellStart.assign(columns * rows + 1, 0);
+        cursor.assign(columns * rows, 0);
+    }
+
+    // 以 store 目前的位置重建網格；已標記 ENTITY_DEAD 的實體不放入
+    void build(const EntityStore& store) {
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+
+        const std::size_t count = store.size();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (store.flags[i] & ENTITY_DEAD) {
+                continue;
+            }
+            forEachCell(store.x[i], store.y[i], store.width[i], store.height[i],
+                        [&](int cell) { ++cellStart[cell + 1]; });
+        }
+        for (std::size_t cell = 1; cell < cellStart.size(); ++cell) {
+            cellStart[cell] += cellStart[cell - 1];
+        }
+
+        // 一次讀 8 格時最後一格之後也要可讀，多出的位置在查詢時以遮罩排除
+        const std::size_t entryCount = cellStart.back();
+        cellEntries.resize(entryCount);
+        entryX.resize(entryCount + 8, 0.f);
+        entryY.resize(entryCount + 8, 0.f);
+        entryWidth.resize(entryCount + 8, 0.f);
+        entryHeight.resize(entryCount + 8, 0.f);
+        std::copy(cellStart.begin(), cellStart.end() - 1, cursor.begin());
+        for (std::size_t i = 0; i < count; ++i) {
+            if (store.flags[i] & ENTITY_DEAD) {
+                continue;
+            }
+            forEachCell(store.x[i], store.y[i], store.width[i], store.height[i], [&](int cell) {
+                const int entry = cursor[cell]++;
+                cellEntries[entry] = static_cast<int>(i);
+                entryX[entry] = store.x[i];
+                entryY[entry] = store.y[i];
+                entryWidth[entry] = store.width[i];
+                entryHeight[entry] = store.height[i];
+            });
+        }
+    }
+
+    // 對可能與 AABB 重疊的每個實體索引呼叫 visit(index)；跨格實體可能重複出現
+    template <typename Visitor>
+    void query(float x, float y, float w, float h, Visitor&& visit) const {
+        forEachCell(x, y, w, h, [&](int cell) {
+            for (int entry = cellStart[cell]; entry < cellStart[cell + 1]; ++entry) {
+                visit(static_cast<std::size_t>(cellEntries[entry]));
+            }
+        });
+    }
+
+    // 找出與 a[i] 重疊、尚未標記刪除且索引最小的 b 實體（與依序巢狀迴圈的結果相同）
+    // 網格必須是以 b 建立的，且建立後 b 的位置沒有改變；找不到時回傳 -1
+    long findFirstOverlap(const EntityStore& a, std::size_t i, const EntityStore& b) const {
+        const SimdBox box(a.x[i], a.y[i], a.width[i], a.height[i]);
+        const SimdKernels& kernels = simdKernels();
+        long first = -1;
+        forEachCell(a.x[i], a.y[i], a.width[i], a.height[i], [&](int cell) {
+            // 每格內的索引是遞增的，第一個有效的重疊就是這一格的最小值
+            for (int entry = cellStart[cell]; entry < cellStart[cell + 1]; entry += 8) {
+                const int lanes = cellStart[cell + 1] - entry;
+                std::uint32_t mask = kernels.overlapMask8(box, &entryX[entry], &entryY[entry], &entryWidth[entry],
+                                                          &entryHeight[entry]);
+                if (lanes < 8) {
+                    mask &= (1u << lanes) - 1;
+                }
+                for (; mask != 0; mask &= mask - 1) {
+                    const long j = cellEntries[entry + lowestSetBit(mask)];
+                    if (!(b.flags[j] & ENTITY_DEAD)) {
+                        if (first < 0 || j < first) {
+                            first = j;
+                        }
+                        return;
+                    }
+                }
+            }
+        });
+        return first;
+    }
+};
+
+// 未使用網格的參考實作：依序檢查所有 b 實體
+inline long findFirstOverlapBruteForce(const EntityStore& a, std::size_t i, const EntityStore& b) {
+    for (std::size_t j = 0; j < b.size(); ++j) {
+        if (!(b.flags[j] & ENTITY_DEAD) && entitiesOverlap(a, i, b, j)) {
+            return static_cast<long>(j);
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexBuffer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 批次繪製器：同一張材質（通常是圖集）的所有方塊依序寫進固定的格子（每格 6 個頂點），
+// 每幀只發出一次 draw call，取代每個物件各自 window.draw。
+//
+// 頂點保存在一個持續存在的串流 sf::VertexBuffer，每一格記錄是否改變：繪製時把連續改變的格子
+// 合成一段，每段以一次 update() 上傳，位置、顏色與材質座標都沒變的格子（靜止的物件）不重新上傳。
+// 插值移動的物件每幀都會改變，全部在動時等於整個重新上傳。不支援 VBO 時退回頂點陣列
+class SpriteBatch : public sf::Drawable {
+private:
+    static const std::size_t VERTICES_PER_QUAD = 6;
+    static const std::size_t RUN_MERGE_GAP = 4;  // 兩段之間沒變的格子不超過這個數時合成一段，減少上傳次數
+
+    std::vector<sf::Vertex> vertices;  // 所有用過的格子，begin() 不清除
+    std::size_t quadCount = 0;         // 這一幀寫入的方塊數
+    const sf::Texture* texture = nullptr;
+    mutable sf::VertexBuffer buffer;
+    bool useVertexBuffer;
+
+    mutable std::vector<std::uint8_t> dirtySlots;  // 每一格是否還沒上傳到緩衝區
+    mutable std::size_t uploadedVertices = 0;       // 上一次繪製上傳的頂點數
+    mutable std::size_t uploadRuns = 0;             // 上一次繪製的上傳次數
+
+    static bool sameVertex(const sf::Vertex& a, const sf::Vertex& b) {
+        return a.position == b.position && a.color == b.color && a.texCoords == b.texCoords;
+    }
+
+    // 上傳所有改變的格子；失敗時回傳 false（格子維持未上傳）
+    bool uploadDirtySlots() const {
+        const std::size_t slotCount = dirtySlots.size();
+        std::size_t slot = 0;
+        while (slot < slotCount) {
+            if (!dirtySlots[slot]) {
+                ++slot;
+                continue;
+            }
+            // 一段：從這一格到最後一個改變的格子，中間沒變的格子不超過 RUN_MERGE_GAP
+            const std::size_t begin = slot;
+            std::size_t end = slot + 1;
+            for (std::size_t next = end, clean = 0; next < slotCount && clean <= RUN_MERGE_GAP; ++next) {
+                if (dirtySlots[next]) {
+                    end = next + 1;
+                    clean = 0;
+                } else {
+                    ++clean;
+                }
+            }
+
+            const std::size_t first = begin * VERTICES_PER_QUAD;
+            const std::size_t count = (end - begin) * VERTICES_PER_QUAD;
+            if (!buffer.update(&vertices[first], count, static_cast<unsigned int>(first))) {
+                return false;
+            }
+            std::fill(dirtySlots.begin() + begin, dirtySlots.begin() + end, 0);
+            uploadedVertices += count;
+            ++uploadRuns;
+            slot = end;
+        }
+        return true;
+    }
+
+public:
+    SpriteBatch()
+        : buffer(sf::Triangles, sf::VertexBuffer::Stream), useVertexBuffer(sf::VertexBuffer::isAvailable()) {}
+
+    // 每幀開始時呼叫，從第一格重新寫入（保留上一幀的頂點用來比較）
+    void begin(const sf::Texture* batchTexture = nullptr) {
+        quadCount = 0;
+        texture = batchTexture;
+    }
+
+    // 寫入下一格：軸對齊方塊；texRect 為材質上的像素範圍，沒有材質時忽略
+    void addQuad(const sf::FloatRect& rect, const sf::Color& color, const sf::FloatRect& texRect = sf::FloatRect()) {
+        const float left = rect.left;
+        const float top = rect.top;
+        const float right = rect.left + rect.width;
+        const float bottom = rect.top + rect.height;
+        const float u0 = texRect.left;
+        const float v0 = texRect.top;
+        const float u1 = texRect.left + texRect.width;
+        const float v1 = texRect.top + texRect.height;
+        const sf::Vertex quad[VERTICES_PER_QUAD] = {
+            sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)),
+            sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)),
+            sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)),
+            sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)),
+            sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)),
+            sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)),
+        };
+
+        const std::size_t slot = quadCount++;
+        const std::size_t first = slot * VERTICES_PER_QUAD;
+        if (vertices.size() < first + VERTICES_PER_QUAD) {
+            vertices.resize(first + VERTICES_PER_QUAD);
+            dirtySlots.resize(slot + 1);
+        } else if (std::equal(quad, quad + VERTICES_PER_QUAD, vertices.begin() + first, sameVertex)) {
+            return;  // 與這一格上一次的內容相同
+        }
+        std::copy(quad, quad + VERTICES_PER_QUAD, vertices.begin() + first);
+        dirtySlots[slot] = 1;
+    }
+
+    std::size_t getVertexCount() const {
+        return quadCount * VERTICES_PER_QUAD;
+    }
+
+    // 上一次繪製實際上傳到緩衝區的頂點數
+    std::size_t getUploadedVertexCount() const {
+        return uploadedVertices;
+    }
+
+    // 上一次繪製呼叫 update() 上傳的次數（段數）
+    std::size_t getUploadRunCount() const {
+        return uploadRuns;
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        const std::size_t count = getVertexCount();
+        uploadedVertices = 0;
+        uploadRuns = 0;
+        if (count == 0) {
+            return;
+        }
+
+        states.texture = texture;
+
+        if (useVertexBuffer) {
+            // 格子數超過緩衝區時重新配置（預留空間），內容要整個重新上傳
+            if (buffer.getVertexCount() < vertices.size()) {
+                if (!buffer.create(vertices.capacity() * 2)) {
+                    target.draw(vertices.data(), count, sf::Triangles, states);
+                    return;
+                }
+                std::fill(dirtySlots.begin(), dirtySlots.end(), 1);
+            }
+            if (!uploadDirtySlots()) {
+                target.draw(vertices.data(), count, sf::Triangles, states);
+                return;
+            }
+            target.draw(buffer, 0, count, states);
+            return;
+        }
+        target.draw(vertices.data(), count, sf::Triangles, states);
+    }
+};
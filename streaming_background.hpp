@@ -0,0 +1,270 @@
+#pragma once
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include "asset_loader.hpp"
+#include "background_animation.hpp"
+#include "asset_pack.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 串流播放的背景動畫（像影片一樣）：解碼執行緒依播放位置預先解碼後面幾幀，
+// 放進固定數量的格子；繪製執行緒把解碼好的幀上傳到格子自己的 sf::Texture，到時間就切換。
+// 同時存在的幀最多 depth 張（像素與材質各一份），記憶體用量與動畫長度無關；
+// 代價是播放期間一直在解碼，所以只用於超過預載預算的長或大的動畫（見 createBackgroundAnimation()）。
+//
+// 播放時間為準：到時間的幀還沒準備好時繼續顯示上一幀並記為延遲（late），
+// 一直沒有顯示就被跳過的幀記為丟棄（dropped）。
+// update()、draw() 與統計只能在繪製執行緒（擁有 OpenGL context 的執行緒）呼叫
+class StreamingBackground : public BackgroundAnimation {
+private:
+    enum SlotState {
+        SLOT_FREE,
+        SLOT_DECODING,  // 解碼執行緒擁有
+        SLOT_DECODED,   // 等待上傳
+        SLOT_UPLOADED,
+    };
+
+    struct Slot {
+        SlotState state = SLOT_FREE;
+        std::size_t frame = 0;  // 播放序號（不取模，循環播放時持續遞增）
+        DecodedImage decoded;
+        sf::Texture texture;
+    };
+
+    static const std::size_t NO_FRAME = static_cast<std::size_t>(-1);
+
+    std::vector<std::string> paths;
+    const AssetPack* pack;
+    float frameTime;
+    sf::Vector2f windowSize;
+    std::vector<Slot> slots;
+
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::size_t nextDecode = 0;  // 下一個要解碼的播放序號
+    std::size_t playhead = 0;    // 目前應該顯示的播放序號
+    bool stopping = false;
+    std::thread decoder;
+    std::atomic<std::size_t> decodedCount{0};
+    std::atomic<std::size_t> packMisses{0};
+
+    // 以下只在繪製執行緒存取
+    float currentTime = 0.f;
+    std::size_t dueFrame = 0;  // playhead 的副本，不必上鎖就能讀
+    std::size_t shownFrame = NO_FRAME;
+    std::size_t lateFrames = 0;
+    std::size_t droppedFrames = 0;
+    std::vector<Slot*> ready;  // 這一次要上傳的格子（保留容量）
+    sf::Sprite sprite;
+    sf::RectangleShape placeholder;
+
+    void decoderLoop() {
+        for (;;) {
+            Slot* slot = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeUp.wait(lock, [this] {
+                    return stopping || std::any_of(slots.begin(), slots.end(),
+                                                   [](const Slot& s) { return s.state == SLOT_FREE; });
+                });
+                if (stopping) {
+                    return;
+                }
+                for (auto& candidate : slots) {
+                    if (candidate.state == SLOT_FREE) {
+                        slot = &candidate;
+                        break;
+                    }
+                }
+                // 落後時直接跳到目前的播放位置，已經過時的幀不必解碼
+                nextDecode = std::max(nextDecode, playhead);
+                slot->frame = nextDecode++;
+                slot->state = SLOT_DECODING;
+            }
+
+            slot->decoded = DecodedImage();
+            slot->decoded.path = paths[slot->frame % paths.size()];
+            decodeAsset(pack, slot->decoded);
+            if (!slot->decoded.fromPack && slot->decoded.loaded) {
+                packMisses.fetch_add(1, std::memory_order_relaxed);
+            }
+            decodedCount.fetch_add(1, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot->state = SLOT_DECODED;
+        }
+    }
+
+    void show(Slot& slot) {
+        sprite.setTexture(slot.texture, true);
+        const sf::Vector2u size = slot.texture.getSize();
+        sprite.setScale(windowSize.x / size.x, windowSize.y / size.y);
+        if (shownFrame != NO_FRAME && slot.frame > shownFrame + 1) {
+            droppedFrames += slot.frame - shownFrame - 1;
+        }
+        shownFrame = slot.frame;
+    }
+
+public:
+    // paths 為完整路徑（依播放順序）；depth 為同時存在的幀數（至少 2：顯示中一張加上預先解碼的）。
+    // assetPack 必須比背景活得久
+    StreamingBackground(const std::vector<std::string>& framePaths, float frameDuration, const sf::Vector2f& size,
+                        std::size_t depth = 4, const AssetPack* assetPack = nullptr)
+        : paths(framePaths), pack(assetPack), frameTime(frameDuration), windowSize(size),
+          slots(std::max<std::size_t>(depth, 2)) {
+        placeholder.setSize(windowSize);
+        placeholder.setFillColor(PLACEHOLDER_COLOR);
+        if (!paths.empty()) {
+            decoder = std::thread(&StreamingBackground::decoderLoop, this);
+        }
+    }
+
+    ~StreamingBackground() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        if (decoder.joinable()) {
+            decoder.join();
+        }
+    }
+
+    StreamingBackground(const StreamingBackground&) = delete;
+    StreamingBackground& operator=(const StreamingBackground&) = delete;
+
+    // 推進播放時間，上傳解碼好的幀並切換到目前的幀
+    void update(float deltaTime) override {
+        if (paths.empty()) {
+            return;
+        }
+        currentTime += deltaTime;
+        const std::size_t previousDue = dueFrame;
+        while (currentTime >= frameTime) {
+            currentTime -= frameTime;
+            ++dueFrame;
+        }
+        const std::size_t due = dueFrame;
+
+        bool freed = false;
+        ready.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            playhead = due;
+            // 已經過時的幀中只保留最新的一張（解碼跟不上時仍然顯示它），其餘直接釋放
+            std::size_t newest = shownFrame;
+            for (const auto& slot : slots) {
+                if ((slot.state == SLOT_DECODED || slot.state == SLOT_UPLOADED) && slot.frame <= due &&
+                    (newest == NO_FRAME || slot.frame > newest)) {
+                    newest = slot.frame;
+                }
+            }
+            for (auto& slot : slots) {
+                if ((slot.state == SLOT_DECODED || slot.state == SLOT_UPLOADED) && newest != NO_FRAME &&
+                    slot.frame < newest && slot.frame != shownFrame) {
+                    slot.state = SLOT_FREE;
+                    freed = true;
+                } else if (slot.state == SLOT_DECODED) {
+                    ready.push_back(&slot);
+                }
+            }
+        }
+
+        // 上傳（解碼執行緒不會碰 DECODED 的格子），依播放順序
+        std::sort(ready.begin(), ready.end(), [](const Slot* a, const Slot* b) { return a->frame < b->frame; });
+        if (ready.size() > UPLOADS_PER_UPDATE) {
+            ready.resize(UPLOADS_PER_UPDATE);
+        }
+        for (Slot* slot : ready) {
+            const sf::Vector2u size = slot->decoded.getSize();
+            if (slot->decoded.loaded && (slot->texture.getSize() == size || slot->texture.create(size.x, size.y))) {
+                slot->texture.update(slot->decoded.getPixels());
+            } else {
+                slot->texture = sf::Texture();  // 載入失敗的幀不顯示
+            }
+            slot->decoded = DecodedImage();  // 像素已在材質中，釋放 CPU 端的副本
+        }
+
+        // 找目前應該顯示的幀：不超過 due 的已上傳幀中最新的一張
+        Slot* best = nullptr;
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Slot* slot : ready) {
+                slot->state = SLOT_UPLOADED;
+            }
+            for (auto& slot : slots) {
+                if (slot.state == SLOT_UPLOADED && slot.frame <= due && slot.texture.getSize().x > 0 &&
+                    (!best || slot.frame > best->frame)) {
+                    best = &slot;
+                }
+            }
+            if (best && best->frame != shownFrame) {
+                for (auto& slot : slots) {
+                    if (slot.state == SLOT_UPLOADED && slot.frame < best->frame) {
+                        slot.state = SLOT_FREE;  // 上一張顯示的幀
+                        freed = true;
+                    }
+                }
+                changed = true;
+            }
+        }
+        if (changed) {
+            show(*best);
+        }
+        if (freed) {
+            wakeUp.notify_one();
+        }
+        // 進到新的一幀時還沒有這一幀可以顯示
+        if (due != previousDue && shownFrame != due) {
+            ++lateFrames;
+        }
+    }
+
+    void draw(sf::RenderTarget& target) override {
+        if (shownFrame == NO_FRAME) {
+            Profiler::get().draw(target, placeholder);
+        } else {
+            Profiler::get().draw(target, sprite);
+        }
+    }
+
+    std::size_t getDepth() const {
+        return slots.size();
+    }
+
+    const char* getModeName() const override {
+        return "streaming";
+    }
+
+    std::size_t getLateFrameCount() const override {
+        return lateFrames;
+    }
+
+    std::size_t getDroppedFrameCount() const override {
+        return droppedFrames;
+    }
+
+    // 包含重複播放時再次解碼的
+    std::size_t getDecodedCount() const override {
+        return decodedCount.load(std::memory_order_relaxed);
+    }
+
+    std::size_t getPackMissCount() const override {
+        return packMisses.load(std::memory_order_relaxed);
+    }
+
+    std::size_t getFrameCount() const override {
+        return paths.size();
+    }
+};
@@ -5,6 +5,29 @@
 #include <iostream>  // 添加這行
 #include <filesystem>  // 添加這行
 #include <memory>  // 添加這行
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "asset_loader.hpp"
+#include "asset_resolver.hpp"
+#include "background_factory.hpp"
+#include "entity_store.hpp"
+#include "event_scheduler.hpp"
+#include "fixed_timestep.hpp"
+#include "hud_text.hpp"
+#include "game_random.hpp"
+#include "input_recording.hpp"
+#include "job_system.hpp"
+#include "logger.hpp"
+#include "profiler.hpp"
+#include "render_layer.hpp"
+#include "render_snapshot.hpp"
+#include "shape_sprites.hpp"
+#include "spatial_grid.hpp"
+#include "sprite_batch.hpp"
+#include "texture_atlas.hpp"
+#include "tick_input.hpp"
 using namespace sf;
 using namespace std;
 
@@ -13,214 +36,265 @@ const float BOUNDARY_LEFT = 200.f;    // 左邊界
 const float PLAY_AREA_WIDTH = 800.f;  // 遊戲區域寬度
 const float ENEMY_WIDTH = 30.f;       // 敵人寬度
 const float BOUNDARY_RIGHT = BOUNDARY_LEFT + PLAY_AREA_WIDTH;  // 右邊界
-
-class Bullet {
-public:
-    CircleShape shape;
-    float speed;
-
-    Bullet(float startX, float startY) {
-        speed = 1.0f;
-        shape.setRadius(5.f);
-        shape.setFillColor(Color::Yellow);
-        shape.setPosition(startX, startY);
+const float PLAY_AREA_HEIGHT = 800.f;  // 遊戲區域高度（與視窗同高）
+const size_t STRESS_BULLET_COUNT = 50000;  // 壓力測試模式維持的子彈數量
+const float COLLISION_CELL_SIZE = 64.f;    // 碰撞網格每格邊長
+const size_t BULLET_POOL_CAPACITY = 256;   // 子彈池預先配置的容量（壓力測試另外加上 STRESS_BULLET_COUNT）
+const size_t ENEMY_POOL_CAPACITY = 64;
+const size_t PARALLEL_GRAIN = 2048;        // 平行更新時每個區塊的實體數；少於一個區塊時不分派
+
+// 子彈參數（子彈本身以結構陣列存放在 Game 中）
+const float BULLET_RADIUS = 5.f;
+const float BULLET_SPEED = 1000.f;       // 每秒移動的像素
+const Color BULLET_COLOR(255, 255, 0);   // 黃色
+
+// 敵人參數
+const float ENEMY_SPEED = 100.f;         // 每秒移動的像素
+const Color ENEMY_COLOR(255, 0, 0);      // 紅色
+const float ENEMY_SPAWN_INTERVAL = 2.0f; // 2秒生一個敵人
+
+// 玩家參數（玩家以中心點定位）
+const float PLAYER_WIDTH = 90.f;         // 繪製與碰撞的寬度
+const float PLAYER_HEIGHT = 140.f;       // 繪製與碰撞的高度
+const float PLAYER_Y = 730.f;
+const float PLAYER_MOVE_SPEED = 200.f;   // 每秒移動的像素
+const float AUTO_SHOOT_INTERVAL = 0.5f;  // 每0.5秒自動發射一次
+const float MAX_HEALTH = 100.f;
+const float INVINCIBILITY_DURATION = 1.0f;  // 受傷後的無敵時間
+const int STARTING_GOLD = 30000;         // 初始金幣
+const int KILLS_TO_WIN = 10;
+
+const unsigned int HEADLESS_SEED = 12345;           // 無頭模式的固定亂數種子
+const unsigned long HEADLESS_DEFAULT_TICKS = 120000;  // 無頭模式預設 tick 數（模擬 1000 秒）
+
+// 資源路徑都相對於資源根目錄（見 asset_resolver.hpp）
+const std::string FONT_PATH = "arial.ttf";
+const std::string PLAYER_TEXTURE_PATH = "texture/character/player.png";
+const std::string COMMON_ASSET_GROUP = "common";  // 資源清單中啟動時載入的群組
+const std::string LEVEL_ASSET_GROUP = "level1";   // 資源清單中這一關的群組
+
+// 預先解碼的資源包
+const std::string ASSET_PACK_PATH = "assets.pak";
+
+const float BACKGROUND_FRAME_TIME = 0.1f;          // 背景動畫每幀的秒數
+
+// 沒有資源清單時使用的背景動畫幀
+std::vector<std::string> getBackgroundFramePaths() {
+    std::vector<std::string> framePaths;
+    for (int i = 1; i <= 24; i++) {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "texture/background/frames/frame_%03d.png", i);
+        framePaths.push_back(buffer);
     }
-
-    void update() {
-        shape.move(0, -speed);
+    return framePaths;
+}
+
+// 這一關的背景幀，依資源清單的順序
+std::vector<std::string> getLevelFramePaths(const AssetResolver& assets) {
+    std::vector<std::string> frames = assets.getGroup(LEVEL_ASSET_GROUP);
+    return frames.empty() ? getBackgroundFramePaths() : frames;
+}
+
+// 所有會放進資源包的圖片（已解析成完整路徑）
+std::vector<std::string> getAllAssetPaths(const AssetResolver& assets) {
+    std::vector<std::string> paths;
+    paths.push_back(assets.resolve(PLAYER_TEXTURE_PATH));
+    for (const auto& frame : getLevelFramePaths(assets)) {
+        paths.push_back(assets.resolve(frame));
     }
-};
-
-// 添加敵人類
-class Enemy {
-public:
-    sf::RectangleShape shape;
-    float speed;
-    
-    Enemy(float startX, float startY) {
-        speed = 0.1f;
-        shape.setSize(sf::Vector2f(30.f, 30.f));  // 確保敵人有合適的大小
-        shape.setPosition(startX, startY);
-        shape.setFillColor(sf::Color::Red);
+    return paths;
+}
+
+// --build-asset-pack：把所有圖片預先解碼成資源包；已存在的資源包中內容沒變的項目直接沿用
+int runAssetPackBuild(const AssetResolver& assets, bool compress) {
+    sf::Clock buildClock;
+    const std::string packPath = assets.resolve(ASSET_PACK_PATH);
+    AssetPack previous;
+    previous.open(packPath);
+    if (!buildAssetPack(getAllAssetPaths(assets), packPath, compress, previous.isOpen() ? &previous : nullptr)) {
+        cout << "Error writing asset pack: " << packPath << endl;
+        return 1;
     }
+    previous.close();
 
-    void update() {
-        shape.move(0, speed);
-    }
+    AssetPack built;
+    built.open(packPath);
+    cout << "Asset pack " << packPath << ": " << built.getEntryCount() << " images"
+         << (compress ? " (RLE)" : "") << " in " << buildClock.getElapsedTime().asMilliseconds() << " ms" << endl;
+    return 0;
+}
 
-    // 修改碰撞檢測函數以使用 Sprite
-    bool checkCollision(const Sprite& player) const {
-        // 獲取精靈的邊界框
-        FloatRect playerBounds = player.getGlobalBounds();
-        FloatRect enemyBounds = shape.getGlobalBounds();
-        
-        return enemyBounds.intersects(playerBounds);
-    }
+// Game 的定時事件，到期時由 EventScheduler 觸發
+enum GameEvent : std::uint8_t {
+    EVENT_AUTO_SHOOT,
+    EVENT_SPAWN_ENEMY,
+    EVENT_INVINCIBILITY_END,
 };
 
-class AnimatedBackground {
+// 遊戲模擬：子彈、敵人、玩家、計分與勝負判定。不依賴視窗、鍵盤與材質，
+// 每個 tick 只讀取 TickInput，因此也能在沒有顯示器的環境執行（--headless）
+class Game {
 private:
-    std::vector<sf::Texture> frames;
-    sf::Sprite sprite;
-    float frameTime;
-    float currentTime;
-    size_t currentFrame;
-    sf::Vector2f scale;
+    EntityStore bullets;
+    EntityStore enemies;
+    SpatialGrid enemyGrid;  // 每個 tick 以敵人位置重建的碰撞網格
+    bool stressMode;        // 壓力測試：維持大量子彈，且不會勝利
+    GameRandom random;      // 敵人生成用的亂數；重新開始時不重設，整個過程由種子決定
+    JobSystem* jobs = nullptr;       // 為空時所有更新在目前執行緒執行
+    std::vector<long> bulletHits;    // 平行碰撞查詢的結果，依子彈索引排列
+
+    float playerX;            // 玩家中心點
+    float previousPlayerX;    // 上一個 tick 的玩家位置，用於插值繪製
+    float currentHealth;
+    int killCount;
+    int gold;
+    EventScheduler<GameEvent> events;  // 自動發射、敵人生成與無敵結束（只在遊戲進行中前進）
+    bool isInvincible;
+    bool isGameOver;
+    bool gameWon;
 
 public:
-    AnimatedBackground(const std::vector<std::string>& framePaths, float frameDuration, const sf::Vector2f& windowSize) {
-        frameTime = frameDuration;
-        currentTime = 0.0f;
-        currentFrame = 0;
-
-        // 加載所有幀
-        for (const auto& path : framePaths) {
-            sf::Texture texture;
-            if (!texture.loadFromFile(path)) {
-                std::cout << "Error loading frame: " << path << std::endl;
-                continue;
-            }
-            frames.push_back(texture);
+    // bulletCapacity 為子彈池容量；0 表示依模式使用預設值
+    explicit Game(bool stress = false, std::uint32_t seed = 0, size_t bulletCapacity = 0)
+        : enemyGrid(BOUNDARY_LEFT, 0.f, PLAY_AREA_WIDTH, PLAY_AREA_HEIGHT, COLLISION_CELL_SIZE),
+          stressMode(stress), random(seed) {
+        if (bulletCapacity == 0) {
+            bulletCapacity = BULLET_POOL_CAPACITY + (stress ? STRESS_BULLET_COUNT : 0);
         }
+        bullets.reserve(bulletCapacity);  // 預先配置，持續射擊時不再配置記憶體
+        enemies.reserve(ENEMY_POOL_CAPACITY);
+        reset();
+    }
 
-        if (!frames.empty()) {
-            sprite.setTexture(frames[0]);
-            
-            // 計算縮放比例以適口
-            float scaleX = windowSize.x / frames[0].getSize().x;
-            float scaleY = windowSize.y / frames[0].getSize().y;
-            scale = sf::Vector2f(scaleX, scaleY);
-            sprite.setScale(scale);
-        }
+    // 重新開始：清空實體並恢復玩家狀態
+    void reset() {
+        bullets.clear();
+        enemies.clear();
+        playerX = BOUNDARY_LEFT + PLAY_AREA_WIDTH / 2;  // 在遊戲區域中心
+        previousPlayerX = playerX;
+        currentHealth = MAX_HEALTH;
+        killCount = 0;
+        gold = STARTING_GOLD;
+        events.clear();
+        events.schedule(ticksFromSeconds(AUTO_SHOOT_INTERVAL, SIMULATION_TICK_RATE), EVENT_AUTO_SHOOT);
+        events.schedule(ticksFromSeconds(ENEMY_SPAWN_INTERVAL, SIMULATION_TICK_RATE), EVENT_SPAWN_ENEMY);
+        isInvincible = false;
+        isGameOver = false;
+        gameWon = false;
     }
 
-    void update(float deltaTime) {
-        if (frames.empty()) return;
+    // 大量實體時把移動、碰撞查詢與壓力測試的子彈生成分給工作系統；
+    // 結果依索引順序合併，與單執行緒完全相同
+    void setJobSystem(JobSystem* jobSystem) {
+        jobs = jobSystem;
+    }
 
-        currentTime += deltaTime;
-        if (currentTime >= frameTime) {
-            currentTime = 0;
-            currentFrame = (currentFrame + 1) % frames.size();
-            sprite.setTexture(frames[currentFrame]);
-            sprite.setScale(scale);  // 確保縮放保持不變
-        }
+    // 添加獲取敵人和子彈的方法
+    const EntityStore& getEnemies() const {
+        return enemies;
     }
 
-    void draw(sf::RenderWindow& window) {
-        window.draw(sprite);
+    const EntityStore& getBullets() const {
+        return bullets;
     }
-};
 
-class Game {
-private:
-    RenderWindow& window;
-    std::vector<Bullet> bullets;
-    std::vector<Enemy> enemies;
-    int* killCountPtr;
-    int* goldPtr;  // 添加金幣指針
-    std::unique_ptr<AnimatedBackground> background;  // 使用智能指針管理背景
+    float getPlayerX() const {
+        return playerX;
+    }
 
-public:
-    Game(RenderWindow& win, int* killCount, int* gold) 
-        : window(win), killCountPtr(killCount), goldPtr(gold) {
-        // 輸出當前工作目錄
-        std::cout << "Current working directory: " << std::filesystem::current_path() << std::endl;
-        
-        std::vector<std::string> framePaths;
-        for (int i = 1; i <= 24; i++) {
-            char buffer[256];
-            snprintf(buffer, sizeof(buffer), "/Users/cpcap/GTA6/texture/background/frames/frame_%03d.png", i);
-            std::string path = buffer;
-            std::cout << "Trying to load: " << path << std::endl;  // 輸出嘗試加載的路徑
-            framePaths.push_back(path);
-        }
+    float getPreviousPlayerX() const {
+        return previousPlayerX;
+    }
 
-        background = std::make_unique<AnimatedBackground>(
-            framePaths, 
-            0.1f, 
-            sf::Vector2f(window.getSize().x, window.getSize().y)
-        );
+    // 玩家碰撞框（以中心點為原點）
+    FloatRect getPlayerBounds() const {
+        return FloatRect(playerX - PLAYER_WIDTH / 2, PLAYER_Y - PLAYER_HEIGHT / 2, PLAYER_WIDTH, PLAYER_HEIGHT);
     }
 
-    void update(float deltaTime) {
-        if (background) {
-            background->update(deltaTime);
-        }
-        // ... 其他更新邏輯 ...
+    float getHealth() const {
+        return currentHealth;
     }
 
-    void drawBackground() {
-        if (background) {
-            background->draw(window);
-        }
+    int getKillCount() const {
+        return killCount;
     }
 
-    // 在遊戲主循環中的繪製部分，首先繪製背景
-    void draw() {
-        drawBackground();
-        // ... 繪製其他遊戲元素 ...
+    int getGold() const {
+        return gold;
     }
 
-    // 添加重置方法
-    void reset() {
-        bullets.clear();
-        enemies.clear();
+    bool isWon() const {
+        return gameWon;
     }
 
-    // 添加獲取敵人和子彈的方法
-    const std::vector<Enemy>& getEnemies() const {
-        return enemies;
+    bool isPlaying() const {
+        return !isGameOver && !gameWon;
     }
 
-    const std::vector<Bullet>& getBullets() const {
-        return bullets;
+    // 模擬狀態的雜湊，用來確認重播與錄製的結果完全相同
+    std::uint64_t getStateHash() const {
+        std::uint64_t hash = events.hashState(bullets.hashState(enemies.hashState()));
+        const float values[] = {playerX, currentHealth};
+        const int counters[] = {killCount, gold, isInvincible, isGameOver, gameWon};
+        hash = hashBytes(values, sizeof(values), hash);
+        return hashBytes(counters, sizeof(counters), hash);
     }
 
     // 添加更新方法
-    void updateBullets() {
-        auto bulletIt = bullets.begin();
-        while (bulletIt != bullets.end()) {
-            bulletIt->update();  // 使用 Bullet 類的 update 方法，而不是直接使用 velocity
-            
-            bool bulletHit = false;
-            auto enemyIt = enemies.begin();
-            
-            while (enemyIt != enemies.end()) {
-                if (bulletIt->shape.getGlobalBounds().intersects(enemyIt->shape.getGlobalBounds())) {
-                    (*killCountPtr)++;
-                    (*goldPtr) += 1000;
-                    
-                    std::cout << "擊中敵人！當前金幣: " << *goldPtr << std::endl;
-                    
-                    enemyIt = enemies.erase(enemyIt);
-                    bulletHit = true;
-                    break;
-                } else {
-                    ++enemyIt;
-                }
+    void updateBullets(float deltaTime) {
+        PROFILE_SCOPE("updateBullets");
+        // 先線性推進所有子彈，再做碰撞
+        parallelFor(jobs, bullets.size(), PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+            bullets.integrateRange(begin, end, deltaTime);
+        });
+
+        PROFILE_SCOPE("collision: bullets");
+        enemyGrid.build(enemies);      // 以敵人目前位置重建網格
+
+        // broad-phase 查詢只讀取資料，可以平行；擊殺依子彈順序在下面合併
+        bulletHits.resize(bullets.size());
+        parallelFor(jobs, bullets.size(), PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                bulletHits[i] = enemyGrid.findFirstOverlap(bullets, i, enemies);
+            }
+        });
+        
+        for (size_t bulletIndex = 0; bulletIndex < bullets.size(); ++bulletIndex) {
+            long enemyIndex = bulletHits[bulletIndex];
+            if (enemyIndex >= 0 && (enemies.flags[enemyIndex] & ENTITY_DEAD)) {
+                // 前面的子彈已經擊殺這個敵人：與依序處理相同，改找下一個重疊的敵人
+                enemyIndex = enemyGrid.findFirstOverlap(bullets, bulletIndex, enemies);
+            }
+            if (enemyIndex >= 0) {
+                killCount++;
+                gold += 1000;
+                
+                LOG_DEBUG("擊中敵人！當前金幣: %d", gold);
+                
+                enemies.kill(enemyIndex);
+                bullets.kill(bulletIndex);
             }
-            
             // 將 isOutOfBounds 檢查移到 Game 類內部
-            bool outOfBounds = bulletIt->shape.getPosition().y < 0;
-            
-            if (bulletHit || outOfBounds) {
-                bulletIt = bullets.erase(bulletIt);
-            } else {
-                ++bulletIt;
+            else if (bullets.y[bulletIndex] < 0) {
+                bullets.kill(bulletIndex);
             }
         }
     }
 
-    void updateEnemies() {
-        for (auto& enemy : enemies) {
-            enemy.update();
-        }
+    // tick 結束時統一移除這個 tick 內被標記刪除的子彈和敵人
+    void compact() {
+        bullets.compact();
+        enemies.compact();
+    }
+
+    void updateEnemies(float deltaTime) {
+        PROFILE_SCOPE("updateEnemies");
+        enemies.integrate(deltaTime);
     }
 
     // 添加子彈和敵人
     void addBullet(float x, float y) {
-        Bullet bullet(x, y);
-        bullets.push_back(bullet);
+        bullets.add(x, y, BULLET_RADIUS * 2.f, BULLET_RADIUS * 2.f, 0.f, -BULLET_SPEED);
     }
 
     void addEnemy(float x, float y) {
@@ -237,77 +311,613 @@ public:
             x = ENEMY_BOUNDARY_RIGHT - ENEMY_WIDTH;
         }
 
-        Enemy enemy(x, y);
-        std::cout << "最終敵人位置X: " << x << std::endl;
-        std::cout << "------------------------" << std::endl;
-        enemies.push_back(enemy);
+        LOG_DEBUG("最終敵人位置X: %.2f", x);
+        enemies.add(x, y, ENEMY_WIDTH, ENEMY_WIDTH, 0.f, ENEMY_SPEED);
     }
 
+    // 標記刪除，實際移除延到 compact()
     void removeEnemy(size_t index) {
         if (index < enemies.size()) {
-            enemies.erase(enemies.begin() + index);
+            enemies.kill(index);
         }
     }
 
-    // 修改 getEnemies 方法返回引用，這樣可以直接修改敵人容器
-    std::vector<Enemy>& getEnemies() {
-        return enemies;
+    // 修改檢測玩家碰撞的方法
+    bool checkPlayerCollision(const FloatRect& playerBounds) const {
+        PROFILE_SCOPE("collision: player");
+        return findFirstEntityOverlapping(enemies, playerBounds) >= 0;
     }
 
-    // 修改檢測玩家碰撞的方法
-    bool checkPlayerCollision(const Sprite& playerSprite) {
-        for (const auto& enemy : enemies) {
-            if (enemy.checkCollision(playerSprite)) {
-                return true;
+    // 扣血；血量歸零時遊戲結束
+    void damagePlayer() {
+        currentHealth = std::max(0.f, currentHealth - 10.f);
+        if (currentHealth <= 0) {
+            isGameOver = true;
+        }
+    }
+
+    // 受傷後的無敵時間，到期時由排程器結束
+    void startInvincibility() {
+        isInvincible = true;
+        events.schedule(ticksFromSeconds(INVINCIBILITY_DURATION, SIMULATION_TICK_RATE), EVENT_INVINCIBILITY_END);
+    }
+
+    // 到期的定時事件；週期性的事件在這裡排入下一次
+    void handleEvent(GameEvent event) {
+        switch (event) {
+        case EVENT_AUTO_SHOOT:
+            // 從玩家中心位置發射子彈
+            addBullet(playerX, PLAYER_Y - PLAYER_HEIGHT / 2.f);
+            events.schedule(ticksFromSeconds(AUTO_SHOOT_INTERVAL, SIMULATION_TICK_RATE), EVENT_AUTO_SHOOT);
+            break;
+        case EVENT_SPAWN_ENEMY: {
+            // 使用新的敵人邊界
+            const float ENEMY_BOUNDARY_LEFT = 250.f;
+            const float ENEMY_BOUNDARY_RIGHT = 950.f;
+            const float ENEMY_WIDTH = 30.f;
+            
+            float randomX = ENEMY_BOUNDARY_LEFT + 
+                random.nextFloat() * 
+                (ENEMY_BOUNDARY_RIGHT - ENEMY_BOUNDARY_LEFT - ENEMY_WIDTH);
+            
+            if (randomX > (ENEMY_BOUNDARY_RIGHT - ENEMY_WIDTH)) {
+                randomX = ENEMY_BOUNDARY_RIGHT - ENEMY_WIDTH;
             }
+            
+            LOG_DEBUG("生成敵人位置X: %.2f", randomX);
+            
+            addEnemy(randomX, 0.f);
+            events.schedule(ticksFromSeconds(ENEMY_SPAWN_INTERVAL, SIMULATION_TICK_RATE), EVENT_SPAWN_ENEMY);
+            break;
+        }
+        case EVENT_INVINCIBILITY_END:
+            isInvincible = false;
+            break;
+        }
+    }
+
+    // 單一 tick 的遊戲邏輯
+    void tick(float dt, const TickInput& input) {
+        PROFILE_SCOPE("Game::tick");
+        // 單次按鍵：除錯與結束畫面的重新開始
+        if (input.isDown(INPUT_RESTART) && !isPlaying()) {
+            reset();
+        }
+        if (input.isDown(INPUT_DEBUG_KILL) && !gameWon) {
+            killCount++;  // 每按一次J增加一個擊殺數
+        }
+        if (input.isDown(INPUT_DEBUG_DAMAGE) && !isGameOver) {
+            damagePlayer();  // 按H鍵扣血
+        }
+        if (!isPlaying()) {
+            return;
+        }
+
+        // 在遊戲循環中，修改碰撞檢測的部分
+        if (!isInvincible) {
+            PROFILE_SCOPE("collision: player");
+            const long enemyIndex = findFirstEntityOverlapping(enemies, getPlayerBounds());
+            if (enemyIndex >= 0) {
+                // 扣血並設置無敵時間
+                damagePlayer();
+                startInvincibility();
+
+                // 增加擊殺數和金幣
+                killCount++;
+                gold += 1000;  // 每擊敗一個敵人增加 1000 金幣
+
+                // 移除敵人
+                removeEnemy(enemyIndex);
+
+                // 檢查是否達到勝利條件
+                if (killCount >= KILLS_TO_WIN && !stressMode) {  // 壓力測試不結束遊戲
+                    gameWon = true;
+                }
+            }
+        }
+
+        // 修改血量檢查邏輯
+        if (currentHealth <= 0) {
+            isGameOver = true;
+            compact();
+            return;
+        }
+
+        // 遊戲邏輯更新
+        previousPlayerX = playerX;
+        if (input.isDown(INPUT_LEFT)) {
+            playerX = std::max(BOUNDARY_LEFT + PLAYER_WIDTH / 2.f, playerX - PLAYER_MOVE_SPEED * dt);  // 考慮中心點偏移
+        }
+        if (input.isDown(INPUT_RIGHT)) {
+            playerX = std::min(BOUNDARY_RIGHT - PLAYER_WIDTH / 2.f, playerX + PLAYER_MOVE_SPEED * dt);  // 考慮中心點偏移
         }
-        return false;
+        
+        // 觸發這個 tick 到期的事件（自動發射、敵人生成、無敵結束）
+        events.advance([this](GameEvent event) { handleEvent(event); });
+
+        // 壓力測試：把子彈補滿到固定數量
+        // 每顆子彈依序用掉兩個亂數，區塊各自把亂數跳到自己的起點，結果與依序生成相同
+        if (stressMode && bullets.size() < STRESS_BULLET_COUNT) {
+            const size_t missing = STRESS_BULLET_COUNT - bullets.size();
+            const size_t first = bullets.append(missing, BULLET_RADIUS * 2.f, BULLET_RADIUS * 2.f, 0.f, -BULLET_SPEED);
+            const GameRandom spawnRandom = random;
+            parallelFor(jobs, missing, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+                GameRandom chunkRandom = spawnRandom;
+                chunkRandom.advance(2 * begin);
+                for (size_t i = first + begin; i < first + end; ++i) {
+                    bullets.x[i] = bullets.previousX[i] = BOUNDARY_LEFT + chunkRandom.nextFloat() * PLAY_AREA_WIDTH;
+                    bullets.y[i] = bullets.previousY[i] = chunkRandom.nextFloat() * PLAY_AREA_HEIGHT;
+                }
+            });
+            random.advance(2 * missing);
+        }
+
+        // 更新遊戲邏輯
+        updateBullets(dt);
+        updateEnemies(dt);
+
+        // 檢測玩家和敵人的碰撞（只扣血，不移除敵人）
+        if (!isInvincible && checkPlayerCollision(getPlayerBounds())) {
+            damagePlayer();
+            startInvincibility();
+        }
+
+        // 先檢查勝利條件
+        if (killCount >= KILLS_TO_WIN && !stressMode) {  // 壓力測試不結束遊戲
+            gameWon = true;  // 設置勝利狀態
+            isGameOver = false;  // 確保不會觸發遊戲結束
+        }
+        // 再檢查失敗條件
+        else if (currentHealth <= 0) {
+            isGameOver = true;
+            gameWon = false;
+        }
+
+        // tick 結束時統一移除被標記刪除的實體
+        compact();
     }
 };
 
-int main() {
+// 繪製一幀需要的遊戲狀態，由模擬執行緒在 tick 之後複製，繪製執行緒只讀取
+struct WorldSnapshot {
+    struct Entity {
+        float previousX, previousY;
+        float x, y;
+        float width, height;
+
+        Vector2f getInterpolatedPosition(float alpha) const {
+            return Vector2f(previousX + (x - previousX) * alpha, previousY + (y - previousY) * alpha);
+        }
+    };
+
+    std::vector<Entity> enemies;
+    std::vector<Entity> bullets;
+    float playerX = 0.f;
+    float previousPlayerX = 0.f;
+    float health = 0.f;
+    int killCount = 0;
+    int gold = 0;
+    bool playing = true;
+    bool won = false;
+    float playTime = 0.f;               // 遊戲中累計的模擬時間，驅動背景動畫
+    std::uint64_t tick = 0;             // 已執行的 tick 數
+    double producedAtUs = 0.0;          // 發布時間（snapshotClockUs）
+    float publishAlpha = 0.f;           // 發布時尚未模擬的時間（tick 的比例）
+    std::size_t bulletAllocations = 0;
+    std::size_t enemyAllocations = 0;
+    std::vector<Profiler::Section> simulationSections;
+};
+
+void copyEntities(const EntityStore& store, std::vector<WorldSnapshot::Entity>& entities) {
+    entities.resize(store.size());
+    for (size_t i = 0; i < store.size(); ++i) {
+        entities[i] = {store.previousX[i], store.previousY[i], store.x[i], store.y[i], store.width[i], store.height[i]};
+    }
+}
+
+// 把遊戲狀態寫進快照（vector 沿用原本的容量）
+void captureSnapshot(const Game& game, WorldSnapshot& snapshot) {
+    copyEntities(game.getEnemies(), snapshot.enemies);
+    copyEntities(game.getBullets(), snapshot.bullets);
+    snapshot.playerX = game.getPlayerX();
+    snapshot.previousPlayerX = game.getPreviousPlayerX();
+    snapshot.health = game.getHealth();
+    snapshot.killCount = game.getKillCount();
+    snapshot.gold = game.getGold();
+    snapshot.playing = game.isPlaying();
+    snapshot.won = game.isWon();
+    snapshot.bulletAllocations = game.getBullets().getAllocationCount();
+    snapshot.enemyAllocations = game.getEnemies().getAllocationCount();
+}
+
+// 比對重播結束時的狀態與錄製時是否相同
+bool reportReplayResult(const InputRecording& recording, std::uint64_t stateHash) {
+    const bool matches = stateHash == recording.finalStateHash;
+    std::cout << "Replay of " << recording.tickCount << " ticks finished: "
+              << (matches ? "state matches recording" : "STATE DIVERGED from recording") << std::endl;
+    return matches;
+}
+
+// --headless：不開視窗、不載入資源，以腳本輸入執行固定數量的 tick 並回報速度。
+// 遊戲結束或勝利時自動重新開始，讓長時間的量測維持在遊戲中。
+// 指定 replayPath 時改用錄製的種子與輸入，tick 數與錄製相同；
+// 指定 tracePath 時每個 tick 視為一幀量測，結束時寫出追蹤檔
+int runHeadless(unsigned long tickCount, const std::string& script, bool stressMode,
+                const std::string& recordPath, const std::string& replayPath, const std::string& tracePath,
+                unsigned int threadCount) {
+    InputReplay replay;
+    std::uint32_t seed = HEADLESS_SEED;  // 固定種子，每次執行的敵人生成相同
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            std::cout << "Error loading input recording: " << replayPath << std::endl;
+            return 1;
+        }
+        seed = replay.getRecording().seed;
+        stressMode = (replay.getRecording().flags & RECORDING_STRESS) != 0;
+        tickCount = static_cast<unsigned long>(replay.getRecording().tickCount);
+    }
+    Profiler& profiler = Profiler::get();
+    if (!tracePath.empty()) {
+        profiler.startTrace();
+    }
+    JobSystem jobs(threadCount);
+    Game game(stressMode, seed);
+    game.setJobSystem(&jobs);
+    ScriptedInput input(script);
+    InputRecorder recorder(seed, SIMULATION_TICK_RATE, stressMode ? RECORDING_STRESS : 0);
+    const float step = 1.f / SIMULATION_TICK_RATE;
+
+    unsigned long rounds = 1;
+    unsigned long totalKills = 0;
+    size_t peakBullets = 0;
+    sf::Clock clock;
+    for (unsigned long i = 0; i < tickCount; ++i) {
+        TickInput tickInput;
+        if (!replayPath.empty()) {
+            replay.nextTick(tickInput);
+        } else {
+            tickInput = input.next();
+            if (!game.isPlaying()) {
+                tickInput.buttons |= INPUT_RESTART;
+            }
+            recorder.recordTick(tickInput);
+        }
+        if (!game.isPlaying() && tickInput.isDown(INPUT_RESTART)) {
+            totalKills += game.getKillCount();
+            ++rounds;
+        }
+        profiler.beginFrame();
+        game.tick(step, tickInput);
+        profiler.endFrame();
+        peakBullets = std::max(peakBullets, game.getBullets().size());
+    }
+    const float seconds = clock.getElapsedTime().asSeconds();
+    totalKills += game.getKillCount();
+    Logger::get().flush();  // 模擬期間的日誌先寫完，再輸出結果
+
+    std::cout << "Headless: " << tickCount << " ticks (" << tickCount * step << " s simulated) in "
+              << seconds * 1000.f << " ms, " << (seconds > 0.f ? tickCount / seconds : 0.f) << " ticks/s" << std::endl;
+    std::cout << "rounds: " << rounds << "  kills: " << totalKills << "  peak bullets: " << peakBullets
+              << "  enemies: " << game.getEnemies().size() << std::endl;
+    std::cout << "bullet pool capacity: " << game.getBullets().capacity()
+              << "  allocations after reserve: " << game.getBullets().getAllocationCount()
+              << "  SIMD kernels: " << simdKernels().name << std::endl;
+    if (profiler.isTracing()) {
+        std::cout << "tick ms  p50: " << profiler.getFrameTimePercentile(50.f)
+                  << "  p99: " << profiler.getFrameTimePercentile(99.f)
+                  << "  max: " << profiler.getFrameTimePercentile(100.f) << " (last 600 ticks)" << std::endl;
+        if (!profiler.writeTrace(tracePath)) {
+            std::cout << "Error writing profile trace: " << tracePath << std::endl;
+        }
+    }
+
+    if (!replayPath.empty()) {
+        return reportReplayResult(replay.getRecording(), game.getStateHash()) ? 0 : 1;
+    }
+    if (!recordPath.empty() && !recorder.save(recordPath, game.getStateHash())) {
+        std::cout << "Error writing input recording: " << recordPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// 執行緒擴展基準測試：壓力測試模式下分別以 1/2/4/8 個執行緒執行相同的 tick，
+// 回報每個 tick 的耗時，並確認結束時的狀態雜湊與單執行緒相同
+int runThreadBenchmark(unsigned long tickCount) {
+    const unsigned int threadCounts[] = {1, 2, 4, 8};
+    const float step = 1.f / SIMULATION_TICK_RATE;
+    float baselineMs = 0.f;
+    std::uint64_t expectedHash = 0;
+
+    std::cout << "threads  ms/tick  speedup  state" << std::endl;
+    for (unsigned int threads : threadCounts) {
+        JobSystem jobs(threads);
+        Game game(true, HEADLESS_SEED);
+        game.setJobSystem(&jobs);
+        ScriptedInput input;
+        game.tick(step, input.next());  // 第一個 tick 生成全部子彈，不計入
+
+        sf::Clock clock;
+        for (unsigned long i = 0; i < tickCount; ++i) {
+            game.tick(step, input.next());
+        }
+        const float msPerTick = clock.getElapsedTime().asMicroseconds() / 1000.f / tickCount;
+        Logger::get().flush();
+
+        const std::uint64_t hash = game.getStateHash();
+        if (threads == 1) {
+            baselineMs = msPerTick;
+            expectedHash = hash;
+        }
+        std::cout << threads << "  " << msPerTick << "  " << (msPerTick > 0.f ? baselineMs / msPerTick : 0.f) << "x  "
+                  << (hash == expectedHash ? "matches" : "DIVERGED") << std::endl;
+        if (hash != expectedHash) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 碰撞基準測試：比較巢狀迴圈與空間網格在不同數量下的耗時，並確認結果一致
+int runCollisionBenchmark() {
+    const size_t counts[][2] = {{100, 100}, {1000, 1000}, {5000, 5000}, {20000, 5000}};
+    const int repetitions = 5;
+    const float playAreaHeight = 800.f;
+
+    std::cout << "SIMD kernels: " << simdKernels().name << " (GTA6_SIMD=scalar|sse2|avx2|neon to override)" << std::endl;
+    std::cout << "bullets  enemies  nested(ms)  grid(ms)  speedup  hits" << std::endl;
+    for (const auto& count : counts) {
+        srand(12345);
+        EntityStore benchBullets;
+        EntityStore benchEnemies;
+        for (size_t i = 0; i < count[0]; ++i) {
+            float bx = BOUNDARY_LEFT + (static_cast<float>(rand()) / RAND_MAX) * PLAY_AREA_WIDTH;
+            float by = (static_cast<float>(rand()) / RAND_MAX) * playAreaHeight;
+            benchBullets.add(bx, by, BULLET_RADIUS * 2.f, BULLET_RADIUS * 2.f, 0.f, -BULLET_SPEED);
+        }
+        for (size_t i = 0; i < count[1]; ++i) {
+            float ex = BOUNDARY_LEFT + (static_cast<float>(rand()) / RAND_MAX) * (PLAY_AREA_WIDTH - ENEMY_WIDTH);
+            float ey = (static_cast<float>(rand()) / RAND_MAX) * playAreaHeight;
+            benchEnemies.add(ex, ey, ENEMY_WIDTH, ENEMY_WIDTH, 0.f, ENEMY_SPEED);
+        }
+
+        long nestedChecksum = 0;
+        sf::Clock nestedClock;
+        for (int r = 0; r < repetitions; ++r) {
+            for (size_t i = 0; i < benchBullets.size(); ++i) {
+                nestedChecksum += findFirstOverlapBruteForce(benchBullets, i, benchEnemies);
+            }
+        }
+        float nestedMs = nestedClock.getElapsedTime().asMicroseconds() / 1000.f / repetitions;
+
+        SpatialGrid grid(BOUNDARY_LEFT, 0.f, PLAY_AREA_WIDTH, playAreaHeight, COLLISION_CELL_SIZE);
+        long gridChecksum = 0;
+        long hits = 0;
+        sf::Clock gridClock;
+        for (int r = 0; r < repetitions; ++r) {
+            grid.build(benchEnemies);
+            for (size_t i = 0; i < benchBullets.size(); ++i) {
+                long hit = grid.findFirstOverlap(benchBullets, i, benchEnemies);
+                gridChecksum += hit;
+                hits += hit >= 0;
+            }
+        }
+        float gridMs = gridClock.getElapsedTime().asMicroseconds() / 1000.f / repetitions;
+
+        if (nestedChecksum != gridChecksum) {
+            std::cout << "Mismatch between nested loop and grid results!" << std::endl;
+            return 1;
+        }
+        std::cout << count[0] << "  " << count[1] << "  " << nestedMs << "  " << gridMs << "  "
+                  << (gridMs > 0.f ? nestedMs / gridMs : 0.f) << "x  " << hits / repetitions << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // --stress：持續維持大量子彈，用來驗證批次繪製
+    // --bench-collision：不開視窗，只跑碰撞基準測試
+    // --build-asset-pack [--compress]：不開視窗，只建置資源包
+    // --asset-root <目錄>：資源根目錄（也可用環境變數 GTA6_ASSET_ROOT）
+    // --headless <tick 數> [--input-script <腳本>]：不開視窗，以腳本輸入執行模擬並回報 ticks/s
+    // --record <檔案>：把亂數種子與每個 tick 的輸入錄到檔案；--replay <檔案>：重播錄製的輸入
+    // --profile-trace <檔案>：記錄每個量測區段，結束時寫成 CSV（.json 則為 Chrome trace）
+    // --threads <數量>：模擬使用的執行緒數（含主執行緒，預設為核心數）
+    // --bench-threads [tick 數]：不開視窗，比較 1/2/4/8 個執行緒的壓力測試模擬速度
+    // --background-stream：背景動畫一律串流解碼（預設只有超過預載預算的動畫才串流）
+    // --background-depth <幀數>：串流解碼預先解碼的深度（同時存在的幀數，至少 2）
+    // --background-shader：預先載入的背景整段上傳成一張材質，由 shader 選幀（不支援時使用圖集）
+    AssetResolver assets(findAssetRoot(argc, argv));
+    if (!assets.loadManifest()) {
+        cout << "Asset manifest not found in " << assets.getRoot() << ", using built-in asset list" << endl;
+    }
+    bool stressMode = false;
+    bool buildPackOnly = false;
+    bool compressPack = false;
+    unsigned long headlessTicks = 0;
+    std::string inputScript = DEFAULT_INPUT_SCRIPT;
+    std::string recordPath;
+    std::string replayPath;
+    std::string tracePath;
+    unsigned int threadCount = 0;
+    BackgroundOptions backgroundOptions;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--stress") == 0) {
+            stressMode = true;
+        } else if (std::strcmp(argv[i], "--bench-collision") == 0) {
+            return runCollisionBenchmark();
+        } else if (std::strcmp(argv[i], "--build-asset-pack") == 0) {
+            buildPackOnly = true;
+        } else if (std::strcmp(argv[i], "--compress") == 0) {
+            compressPack = true;
+        } else if (std::strcmp(argv[i], "--headless") == 0) {
+            headlessTicks = HEADLESS_DEFAULT_TICKS;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                headlessTicks = std::strtoul(argv[++i], nullptr, 10);
+            }
+        } else if (std::strcmp(argv[i], "--input-script") == 0 && i + 1 < argc) {
+            inputScript = argv[++i];
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile-trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--bench-threads") == 0) {
+            unsigned long benchTicks = 300;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                benchTicks = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+            }
+            return runThreadBenchmark(benchTicks);
+        } else if (std::strcmp(argv[i], "--background-stream") == 0) {
+            backgroundOptions.stream = true;
+        } else if (std::strcmp(argv[i], "--background-depth") == 0 && i + 1 < argc) {
+            backgroundOptions.streamDepth = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--background-shader") == 0) {
+            backgroundOptions.shader = true;
+        }
+    }
+    if (buildPackOnly) {
+        return runAssetPackBuild(assets, compressPack);
+    }
+    if (headlessTicks > 0) {
+        return runHeadless(headlessTicks, inputScript, stressMode, recordPath, replayPath, tracePath, threadCount);
+    }
+
+    // 重播時種子與模式都來自錄製檔，否則以時間作為種子
+    InputReplay replay;
+    bool replaying = false;
+    std::uint32_t seed = static_cast<std::uint32_t>(time(0));
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            cout << "Error loading input recording: " << replayPath << endl;
+            return 1;
+        }
+        replaying = true;
+        seed = replay.getRecording().seed;
+        stressMode = (replay.getRecording().flags & RECORDING_STRESS) != 0;
+    }
+    std::unique_ptr<InputRecorder> recorder;
+    if (!recordPath.empty()) {
+        recorder.reset(new InputRecorder(seed, SIMULATION_TICK_RATE, stressMode ? RECORDING_STRESS : 0));
+    }
+
+    sf::Clock startupClock;  // 量測啟動時間
     RenderWindow window(VideoMode(1200, 800), "SFML works!");
-    srand(time(0));  // 初始化隨機數生成器
-    
-    // 加載玩家材質
-    Texture playerTexture;
-    if (!playerTexture.loadFromFile("/Users/cpcap/GTA6/texture/character/player.png")) {
-        cout << "Error loading player texture!" << endl;
-        cout << "Current working directory: " << filesystem::current_path() << endl;
-        return -1;
+    if (FRAME_RATE_LIMIT > 0 && !stressMode) {
+        window.setFramerateLimit(FRAME_RATE_LIMIT);
     }
-    
-    // 創建玩家精靈替代原來的 CircleShape
-    Sprite playerSprite(playerTexture);
-    // 設置精靈原點為中心
-    playerSprite.setOrigin(playerTexture.getSize().x / 2.f, playerTexture.getSize().y / 2.f);
-    
-    float x = BOUNDARY_LEFT + PLAY_AREA_WIDTH/2;  // 在遊戲區域中心
-    float y = 730.f;  // 原始值是 740.f，我們可以減小這個值來使角色往上移
 
-    playerSprite.setPosition(x, y);
-    
-    // 在 main 函數中，修改玩家精靈的縮放比例
-    float desiredWidth = 90.f;   // 期望的寬度
-    float desiredHeight = 140.f;  // 期望的高度（可以調整這個值來改變高度）
+    // 載入字體
+    sf::Font font;
+    if (!font.loadFromFile(assets.resolve(FONT_PATH))) {
+        std::cout << "Error loading font!" << std::endl;
+    }
 
-    playerSprite.setScale(
-        desiredWidth / playerTexture.getSize().x,
-        desiredHeight / playerTexture.getSize().y
-    );
-    
-    float moveSpeed = 0.2f;
+    // 有資源包時內容沒變的圖片直接使用預先解碼的像素，其餘才解碼 PNG
+    AssetPack assetPack;
+    assetPack.open(assets.resolve(ASSET_PACK_PATH));
+
+    // 只預載啟動與這一關需要的資源；缺少或大小不符的檔案先提出警告
+    for (const auto& group : {COMMON_ASSET_GROUP, LEVEL_ASSET_GROUP}) {
+        for (const auto& path : assets.findMismatches(group)) {
+            cout << "Asset missing or changed since manifest: " << assets.resolve(path) << endl;
+        }
+    }
+    cout << "Preloading " << assets.getGroupSize(COMMON_ASSET_GROUP) + assets.getGroupSize(LEVEL_ASSET_GROUP)
+         << " bytes from " << assets.getRoot() << endl;
+
+    // 玩家材質由一個背景執行緒解碼，一拿到就能開始遊戲
+    AssetLoader loader(1, assetPack.isOpen() ? &assetPack : nullptr);
+    loader.request(PLAYER_TEXTURE_PATH, assets.resolve(PLAYER_TEXTURE_PATH));
+
+    // 背景動畫（只用於繪製）同時開始解碼：放得進預算時預先載入圖集，否則串流解碼（見 background_factory.hpp）
+    std::vector<std::string> levelFrames;
+    for (const auto& path : getLevelFramePaths(assets)) {
+        levelFrames.push_back(assets.resolve(path));
+    }
+    std::unique_ptr<BackgroundAnimation> background =
+        createBackgroundAnimation(levelFrames, BACKGROUND_FRAME_TIME, Vector2f(window.getSize().x, window.getSize().y),
+                                  assetPack.isOpen() ? &assetPack : nullptr, backgroundOptions);
+    cout << "Background animation: " << levelFrames.size() << " frames, " << background->getModeName() << endl;
+
+    // 圖集以相對路徑作為名稱
+    TextureAtlas atlas;
+    bool playerLoaded = false;
+    bool playerFailed = false;
+    bool backgroundReported = false;
+    std::thread packRebuild;
+
+    // 映射的像素不複製，直接從資源包上傳
+    auto addToAtlas = [&](DecodedImage& decoded) {
+        if (decoded.mappedPixels) {
+            atlas.addPixels(decoded.name, decoded.mappedPixels, decoded.mappedSize);
+        } else {
+            atlas.add(decoded.name, std::move(decoded.image));
+        }
+    };
+
+    // 主執行緒收取解碼結果
+    auto collectDecodedImages = [&]() {
+        DecodedImage decoded;
+        while (loader.poll(decoded)) {
+            if (decoded.name == PLAYER_TEXTURE_PATH) {
+                if (decoded.loaded) {
+                    addToAtlas(decoded);
+                    addShapeSprites(atlas, static_cast<unsigned int>(BULLET_RADIUS * 2.f));
+                    playerLoaded = atlas.build();
+                }
+                playerFailed = !playerLoaded;
+            }
+        }
+    };
+
+    // 載入畫面：顯示進度，直到玩家材質可用
+    RectangleShape loadingBarBackground(Vector2f(400.f, 20.f));
+    loadingBarBackground.setPosition(400.f, 400.f);
+    loadingBarBackground.setFillColor(Color(100, 100, 100));
+    RectangleShape loadingBar(Vector2f(0.f, 20.f));
+    loadingBar.setPosition(400.f, 400.f);
+    loadingBar.setFillColor(Color::Green);
+    sf::Text loadingText("Loading...", font, 30);
+    loadingText.setPosition(400.f, 350.f);
+
+    while (window.isOpen() && !playerLoaded && !playerFailed) {
+        Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == Event::Closed)
+                window.close();
+        }
 
-    // 獲取玩家精靈的實際寬度（考慮縮放後的大小）
-    float playerWidth = playerSprite.getGlobalBounds().width;
+        collectDecodedImages();
+        loadingBar.setSize(Vector2f(400.f * loader.getProgress(), 20.f));
 
-    // 設置移動邊界，考慮玩家寬度
-    float leftBound = BOUNDARY_LEFT;                         // 左邊界
-    float rightBound = BOUNDARY_LEFT + PLAY_AREA_WIDTH - playerWidth;  // 右邊界減去玩家寬度
+        window.clear();
+        window.draw(loadingText);
+        window.draw(loadingBarBackground);
+        window.draw(loadingBar);
+        window.display();
+    }
+
+    if (!window.isOpen()) {
+        return 0;
+    }
 
-    // 子彈容器
-    std::vector<Bullet> bullets;
-    bool spacePressed = false;
+    // 加載玩家材質
+    if (playerFailed) {
+        cout << "Error loading player texture!" << endl;
+        cout << "Asset root: " << assets.getRoot() << " (set with --asset-root or " << ASSET_ROOT_ENVIRONMENT << ")" << endl;
+        return -1;
+    }
+    cout << "Time to first playable frame: " << startupClock.getElapsedTime().asMilliseconds() << " ms" << endl;
+    
+    // 玩家材質與敵人、子彈的圖案在同一次 build() 打包進同一頁，所有實體以同一批繪製
+    const TextureAtlas::Region playerRegion = atlas.getRegion(PLAYER_TEXTURE_PATH);
+    const FloatRect playerTexRect(playerRegion.rect);
+    const FloatRect enemyTexRect = getShapeTexRect(atlas, SHAPE_SQUARE);
+    const FloatRect bulletTexRect = getShapeTexRect(atlas, SHAPE_CIRCLE);
 
     // 添加血條
     RectangleShape healthBarBackground(Vector2f(200.f, 20.f));
@@ -324,40 +934,16 @@ int main() {
     // 添加血條邊框
     healthBarBackground.setOutlineThickness(2.f);
     healthBarBackground.setOutlineColor(Color::White);
-    
-    // 設置血量
-    float maxHealth = 100.f;
-    float currentHealth = 100.f;
 
-    // 敵人關變量
-    std::vector<Enemy> enemies;
-    Clock enemySpawnTimer;  // 用於計時生成敵人
-    
-    // 添加無敵時間計時器
-    Clock invincibilityTimer;
-    bool isInvincible = false;
-    float invincibilityDuration = 1.0f;  // 1無敵時間
-
-    // 在創建 Game 實例之前定義 killCount
-    int killCount = 0;
-    int gold = 30000;  // 初始金幣
+    // 添加計數器文字（數值改變時才重建字形）
+    HudLayer hud;
+    HudText& killCountText = hud.add(font, 24, Vector2f(10.f, 10.f), sf::Color::White);
+    killCountText.setPattern("Kills: %ld | Gold: %ld");
 
-    // 載入字體
-    sf::Font font;
-    if (!font.loadFromFile("arial.ttf")) {
-        std::cout << "Error loading font!" << std::endl;
-    }
-
-    // 添加計數器文字
-    sf::Text killCountText;
-    killCountText.setFont(font);
-    killCountText.setCharacterSize(24);
-    killCountText.setFillColor(sf::Color::White);
-    killCountText.setPosition(10.f, 10.f);
-    killCountText.setString("Kills: 0");
-
-    // 建遊戲實例
-    Game game(window, &killCount, &gold);
+    // 建遊戲實例（模擬）
+    JobSystem jobs(threadCount);
+    Game game(stressMode, seed);
+    game.setJobSystem(&jobs);
 
     // 創建遊戲結束文字
     sf::Text gameOverText;
@@ -383,17 +969,6 @@ int main() {
         window.getSize().y/2 + 50
     );
 
-    // 添加遊戲狀態
-    bool isGameOver = false;
-    bool gameWon = false;
-
-    // 添加子彈發射計時器
-    Clock shootTimer;
-    const float shootCooldown = 0.5f;  // 射擊冷卻時間（秒）
-
-    // 添加敵人生成計時器
-    const float enemySpawnInterval = 2.0f;  // 2秒生一個敵人
-
     // 創建勝利文字
     sf::Text gameWonText;
     gameWonText.setFont(font);
@@ -418,259 +993,281 @@ int main() {
         window.getSize().y/2 + 50
     );
 
-    // 在 main 函數開始處添加自動發射的計時器和間隔設置
-    Clock autoShootTimer;  // 自動發射計時器
-    const float autoShootInterval = 0.5f;  // 每0.5秒發射一次，你可以調整這個值
+    // 固定步長模擬：遊戲邏輯以固定頻率在主執行緒執行，繪製執行緒依快照插值，
+    // 模擬速度不受繪製與垂直同步影響
+    FixedTimestep timestep(SIMULATION_TICK_RATE);
 
-    sf::Clock clock;  // 添加時間來計算幀時間
-    
-    while (window.isOpen()) {
-        float deltaTime = clock.restart().asSeconds();
-        
-        Event event;
-        while (window.pollEvent(event))
-        {
-            if (event.type == Event::Closed)
-                window.close();
-            
-            // 添加調試模式的擊殺數增加
-            if (!gameWon && event.type == Event::KeyPressed) {
-                if (event.key.code == Keyboard::J) {
-                    killCount++;  // 每按一次J增加一個擊殺數
-                    // 更新擊殺數顯示
-                    killCountText.setString("Kills: " + std::to_string(killCount) + " | Gold: " + std::to_string(gold));
-                }
-            }
-            
-            // 遊戲結束時的按鍵處理
-            if (isGameOver && event.type == Event::KeyPressed)
-            {
-                if (event.key.code == Keyboard::R)
-                {
-                    // 重置遊戲狀態
-                    currentHealth = maxHealth;
-                    healthBar.setSize(Vector2f(200.f, 20.f));
-                    x = BOUNDARY_LEFT + PLAY_AREA_WIDTH/2;
-                    y = 730.f;
-                    playerSprite.setPosition(x, y);
-                    game.reset();
-                    killCount = 0;  // 重置擊殺數
-                    gold = 30000;   // 重置金幣數量
-                    isGameOver = false;
-                    
-                    // 更新顯示文字
-                    killCountText.setString("Kills: 0 | Gold: 30000");
-                }
-                else if (event.key.code == Keyboard::Escape)
-                {
-                    window.close();
+    // 單次按鍵在下一個 tick 才交給模擬
+    std::uint8_t pendingButtons = 0;
+
+    // 敵人、玩家與子彈都是圖集上的方塊，同一個批次，每幀一次 draw call
+    SpriteBatch entityBatch;
+
+    // 效能量測：模擬與繪製執行緒各有一個 Profiler，F3 切換覆蓋層
+    Profiler& profiler = Profiler::get();
+    Profiler renderProfiler;
+    profiler.setEnabled(true);
+    renderProfiler.setEnabled(true);
+    if (!tracePath.empty()) {
+        profiler.startTrace();
+        renderProfiler.startTrace();
+    }
+    ProfilerOverlay profilerOverlay(font);
+
+    // 執行緒之間的狀態：快照、結束旗標、F3 要求與繪製統計
+    SnapshotExchange<WorldSnapshot> snapshots;
+    std::atomic<bool> running{true};
+    std::atomic<bool> overlayToggleRequested{false};
+    std::atomic<unsigned int> renderedFrames{0};
+    std::atomic<unsigned int> renderDrawCalls{0};
+    std::uint64_t tickCount = 0;
+    float playTime = 0.f;
+
+    auto publishSnapshot = [&]() {
+        WorldSnapshot& snapshot = snapshots.beginWrite();
+        captureSnapshot(game, snapshot);
+        snapshot.playTime = playTime;
+        snapshot.tick = tickCount;
+        snapshot.publishAlpha = timestep.getAlpha();
+        snapshot.simulationSections = profiler.getSections();
+        snapshot.producedAtUs = snapshotClockUs();
+        snapshots.publish();
+    };
+    publishSnapshot();
+
+    // 繪製執行緒：OpenGL context 移到這個執行緒，背景幀的上傳也在這裡進行
+    window.setActive(false);
+    std::thread renderThread([&]() {
+        Profiler::setCurrent(renderProfiler);
+        window.setActive(true);
+        LatencyHistogram latency;
+
+        // 血條與擊殺數畫進快取圖層（在這個執行緒的 context 建立），數值改變時才重畫
+        CachedLayer hudLayer;
+        hudLayer.create(window.getSize().x, window.getSize().y, [&](sf::RenderTarget& target) {
+            target.draw(healthBarBackground);
+            target.draw(healthBar);
+            target.draw(hud);
+        });
+        float shownHealth = -1.f;
+        int shownKills = -1;
+        int shownGold = -1;
+        float lastPlayTime = 0.f;
+        double tickRateStartUs = snapshotClockUs();
+        std::uint64_t tickRateStart = 0;
+
+        while (running.load(std::memory_order_acquire)) {
+            renderProfiler.beginFrame();
+
+            // 背景動畫第一次完整解碼一輪後回報；資源包缺少或過期的圖片在背景重建，下次啟動就不必再解碼
+            if (!backgroundReported && background->getDecodedCount() >= background->getFrameCount()) {
+                backgroundReported = true;
+                LOG_INFO("Background frames decoded in %d ms (asset pack misses: %zu)",
+                         static_cast<int>(startupClock.getElapsedTime().asMilliseconds()),
+                         loader.getPackMissCount() + background->getPackMissCount());
+                if (loader.getPackMissCount() + background->getPackMissCount() > 0) {
+                    packRebuild = std::thread([&assets, &assetPack]() {
+                        buildAssetPack(getAllAssetPaths(assets), assets.resolve(ASSET_PACK_PATH), false,
+                                       assetPack.isOpen() ? &assetPack : nullptr);
+                    });
                 }
             }
 
-            // 添加調試模式的按鍵檢測
-            if (event.type == Event::KeyPressed) {
-                if (event.key.code == Keyboard::H && !isGameOver) {
-                    // 按H鍵扣血
-                    currentHealth = std::max(0.f, currentHealth - 10.f);
-                    healthBar.setSize(Vector2f((currentHealth/maxHealth) * 200.f, 20.f));
-                    
-                    // 如果血量歸，觸發遊戲結束
-                    if (currentHealth <= 0) {
-                        isGameOver = true;
-                    }
-                }
+            if (overlayToggleRequested.exchange(false, std::memory_order_relaxed)) {
+                profilerOverlay.toggle();
             }
 
-            // 添加勝時的按鍵處理
-            if (gameWon && event.type == Event::KeyPressed) {
-                if (event.key.code == Keyboard::R) {
-                    // 重置遊戲狀態
-                    currentHealth = maxHealth;
-                    healthBar.setSize(Vector2f(200.f, 20.f));
-                    x = BOUNDARY_LEFT + PLAY_AREA_WIDTH/2;
-                    y = 730.f;
-                    playerSprite.setPosition(x, y);
-                    game.reset();
-                    killCount = 0;  // 重置擊殺數
-                    gold = 30000;   // 重置金幣數量
-                    gameWon = false;
-                    
-                    // 更新顯示文字
-                    killCountText.setString("Kills: 0 | Gold: 30000");
-                }
-                else if (event.key.code == Keyboard::Escape) {
-                    window.close();
+            // 取最新的快照；插值比例加上發布之後經過的時間，最多推到目前的 tick
+            const WorldSnapshot& world = snapshots.acquire();
+            const float sincePublished =
+                static_cast<float>((snapshotClockUs() - world.producedAtUs) / 1e6) / timestep.getStep();
+            const float alpha = std::min(1.f, world.publishAlpha + sincePublished);
+            background->update(world.playTime - lastPlayTime);  // 背景動畫只在遊戲中前進
+            lastPlayTime = world.playTime;
+
+            window.clear();
+
+            // 修改遊戲狀態檢查的邏輯
+            if (world.playing) {
+                {
+                    PROFILE_SCOPE("draw: background");
+                    background->draw(window);   // 繪製背景
                 }
-            }
-        }
 
-        // 在遊戲循環中，修改碰撞檢測的部分
-        if (!isInvincible) {
-            auto enemyIt = game.getEnemies().begin();
-            while (enemyIt != game.getEnemies().end()) {
-                if (enemyIt->checkCollision(playerSprite)) {
-                    // 扣血
-                    currentHealth = std::max(0.f, currentHealth - 10.f);
-                    healthBar.setSize(Vector2f((currentHealth/maxHealth) * 200.f, 20.f));
-                    
-                    // 設置無敵時間
-                    isInvincible = true;
-                    invincibilityTimer.restart();
-                    
-                    // 增加擊殺數和金幣
-                    killCount++;
-                    gold += 1000;  // 每擊敗一個敵人增加 1000 金幣
-                    
-                    // 立即更新 UI 文字
-                    killCountText.setString("Kills: " + std::to_string(killCount) + " | Gold: " + std::to_string(gold));
-                    
-                    // 移除敵人
-                    enemyIt = game.getEnemies().erase(enemyIt);
-
-                    // 檢查是否達到勝利條件
-                    if (killCount >= 10) {
-                        gameWon = true;
+                // 繪製敵人、玩家和子彈（依上一個 tick 與目前 tick 插值，整批一次繪製）
+                {
+                    PROFILE_SCOPE("draw: entities");
+                    entityBatch.begin(playerRegion.texture);
+                    for (const auto& enemy : world.enemies) {
+                        entityBatch.addQuad(FloatRect(enemy.getInterpolatedPosition(alpha), Vector2f(enemy.width, enemy.height)),
+                                            ENEMY_COLOR, enemyTexRect);
                     }
-                    
-                    // 檢查是否死亡
-                    if (currentHealth <= 0) {
-                        isGameOver = true;
+                    const Vector2f playerPosition = interpolatePosition(Vector2f(world.previousPlayerX, PLAYER_Y),
+                                                                        Vector2f(world.playerX, PLAYER_Y), alpha);
+                    entityBatch.addQuad(FloatRect(playerPosition.x - PLAYER_WIDTH / 2.f, playerPosition.y - PLAYER_HEIGHT / 2.f,
+                                                  PLAYER_WIDTH, PLAYER_HEIGHT),
+                                        Color::White, playerTexRect);
+                    for (const auto& bullet : world.bullets) {
+                        entityBatch.addQuad(FloatRect(bullet.getInterpolatedPosition(alpha),
+                                                      Vector2f(BULLET_RADIUS * 2.f, BULLET_RADIUS * 2.f)),
+                                            BULLET_COLOR, bulletTexRect);
                     }
-                    
-                    break;
-                } else {
-                    ++enemyIt;
+                    renderProfiler.draw(window, entityBatch);
                 }
-            }
-        }
-
-        // 修改血量檢查邏輯
-        if (currentHealth <= 0) {
-            isGameOver = true;
-        }
-
-        window.clear();
 
-        // 修改遊戲狀態檢查的邏輯
-        if (!isGameOver && !gameWon) {  // 確保兩個狀態互斥
-            game.update(deltaTime);  // 更新遊戲狀態，包括背景動畫
-            game.drawBackground();   // 繪製背景
-            
-            // 繪製敵人
-            for (const auto& enemy : game.getEnemies()) {
-                window.draw(enemy.shape);
+                // 繪製條與擊殺數（一個貼上的方塊）
+                PROFILE_SCOPE("draw: HUD");
+                if (world.health != shownHealth || world.killCount != shownKills || world.gold != shownGold) {
+                    shownHealth = world.health;
+                    shownKills = world.killCount;
+                    shownGold = world.gold;
+                    healthBar.setSize(Vector2f((world.health / MAX_HEALTH) * 200.f, 20.f));
+                    killCountText.setValues(world.killCount, world.gold);
+                    hudLayer.invalidate();
+                }
+                renderProfiler.draw(window, hudLayer);
             }
-            
-            // 繪製玩家和子彈
-            window.draw(playerSprite);
-            for (const auto& bullet : game.getBullets()) {
-                window.draw(bullet.shape);
+            else if (world.won) {
+                // 繪製勝利畫面
+                PROFILE_SCOPE("draw: HUD");
+                renderProfiler.draw(window, gameWonText);
+                renderProfiler.draw(window, victoryPromptText);
+                // 不繪製擊殺數和金幣
             }
-            
-            // 繪製條
-            window.draw(healthBarBackground);
-            window.draw(healthBar);
-
-            // 遊戲邏輯更新
-            if (Keyboard::isKeyPressed(Keyboard::Left)) {
-                x = std::max(leftBound + playerWidth/2.f, x - moveSpeed);  // 考慮中心點偏移
+            else {
+                // 繪製遊戲結束畫面
+                PROFILE_SCOPE("draw: HUD");
+                renderProfiler.draw(window, gameOverText);
+                renderProfiler.draw(window, promptText);
+                // 不繪製擊殺數和金幣
             }
-            if (Keyboard::isKeyPressed(Keyboard::Right)) {
-                x = std::min(rightBound + playerWidth/2.f, x + moveSpeed);  // 考慮中心點偏移
+
+            // 每秒更新一次模擬速度
+            const double nowUs = snapshotClockUs();
+            if (nowUs - tickRateStartUs >= 1e6) {
+                renderProfiler.setCounter("simulation ticks/s",
+                                          (world.tick - tickRateStart) * 1e6 / (nowUs - tickRateStartUs));
+                tickRateStart = world.tick;
+                tickRateStartUs = nowUs;
             }
-            
-            // 檢查是否到達發射時間
-            if (autoShootTimer.getElapsedTime().asSeconds() >= autoShootInterval) {
-                // 從玩家中心位置發射子彈
-                float bulletX = playerSprite.getPosition().x;
-                float bulletY = playerSprite.getPosition().y - playerSprite.getGlobalBounds().height/2.f;
-                
-                game.addBullet(bulletX, bulletY);
-                autoShootTimer.restart();  // 重置計時器
+            renderProfiler.setCounter("latency p50 ms", latency.getPercentile(50.f));
+            renderProfiler.setCounter("latency p99 ms", latency.getPercentile(99.f));
+            renderProfiler.setCounter("bullet allocations", static_cast<double>(world.bulletAllocations));
+            renderProfiler.setCounter("enemy allocations", static_cast<double>(world.enemyAllocations));
+            renderProfiler.setCounter("HUD layer redraws", static_cast<double>(hudLayer.getRedrawCount()));
+            renderProfiler.setCounter("entity vertices uploaded",
+                                      static_cast<double>(entityBatch.getUploadedVertexCount()));
+            renderProfiler.setCounter("entity upload runs", static_cast<double>(entityBatch.getUploadRunCount()));
+            renderProfiler.setCounter("background late frames", static_cast<double>(background->getLateFrameCount()));
+            renderProfiler.setCounter("background dropped frames",
+                                      static_cast<double>(background->getDroppedFrameCount()));
+            profilerOverlay.draw(window, renderProfiler, &world.simulationSections);
+            {
+                PROFILE_SCOPE("display");
+                window.display();
             }
+            // 延遲：快照產生到這一幀顯示
+            latency.add(static_cast<float>((snapshotClockUs() - world.producedAtUs) / 1000.0));
+            renderProfiler.endFrame();
+            renderDrawCalls.store(renderProfiler.getDrawCalls(), std::memory_order_relaxed);
+            renderedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        window.setActive(false);
+    });
 
-            // 修改敵人生成邏輯
-            if (enemySpawnTimer.getElapsedTime().asSeconds() >= enemySpawnInterval) {
-                // 使用新的敵人邊界
-                const float ENEMY_BOUNDARY_LEFT = 250.f;
-                const float ENEMY_BOUNDARY_RIGHT = 950.f;
-                const float ENEMY_WIDTH = 30.f;
-                
-                float randomX = ENEMY_BOUNDARY_LEFT + 
-                    (static_cast<float>(rand()) / RAND_MAX) * 
-                    (ENEMY_BOUNDARY_RIGHT - ENEMY_BOUNDARY_LEFT - ENEMY_WIDTH);
-                
-                if (randomX > (ENEMY_BOUNDARY_RIGHT - ENEMY_WIDTH)) {
-                    randomX = ENEMY_BOUNDARY_RIGHT - ENEMY_WIDTH;
-                }
-                
-                std::cout << "生成敵人位置X: " << randomX << std::endl;
-                std::cout << "------------------------" << std::endl;
-                
-                game.addEnemy(randomX, 0.f);
-                enemySpawnTimer.restart();
-            }
+    // 壓力測試統計
+    sf::Clock stressReportClock;
+    unsigned int stressFramesStart = 0;
+
+    timestep.reset();
+    while (running.load(std::memory_order_relaxed)) {
+        profiler.beginFrame();
 
-            // 更新遊戲邏輯
-            game.updateBullets();
-            game.updateEnemies();
-            playerSprite.setPosition(x, y);
-
-            // 檢測玩家和敵人的碰撞
-            if (!isInvincible) {
-                if (game.checkPlayerCollision(playerSprite)) {
-                    // 只血，不移除敵人
-                    currentHealth = std::max(0.f, currentHealth - 10.f);
-                    healthBar.setSize(Vector2f((currentHealth/maxHealth) * 200.f, 20.f));
-                    isInvincible = true;
-                    invincibilityTimer.restart();
-
-                    if (currentHealth <= 0) {
-                        isGameOver = true;
+        {
+            PROFILE_SCOPE("input");
+            Event event;
+            while (window.pollEvent(event))
+            {
+                if (event.type == Event::Closed)
+                    running.store(false, std::memory_order_release);
+
+                if (event.type == Event::KeyPressed) {
+                    if (event.key.code == Keyboard::F3) {
+                        overlayToggleRequested.store(true, std::memory_order_relaxed);  // 效能覆蓋層
+                    } else if (event.key.code == Keyboard::J) {
+                        pendingButtons |= INPUT_DEBUG_KILL;    // 調試模式：增加擊殺數
+                    } else if (event.key.code == Keyboard::H) {
+                        pendingButtons |= INPUT_DEBUG_DAMAGE;  // 調試模式：扣血
+                    } else if (event.key.code == Keyboard::R) {
+                        pendingButtons |= INPUT_RESTART;       // 結束畫面重新開始
+                    } else if (event.key.code == Keyboard::Escape && !game.isPlaying()) {
+                        running.store(false, std::memory_order_release);
                     }
                 }
             }
+        }
 
-            // 更新無敵時間
-            if (isInvincible && invincibilityTimer.getElapsedTime().asSeconds() >= invincibilityDuration) {
-                isInvincible = false;
+        // 固定步長推進遊戲邏輯（結束畫面的 tick 只處理重新開始）
+        const int ticks = timestep.advance([&](float dt) {
+            TickInput input;
+            if (replaying && replay.nextTick(input)) {
+                pendingButtons = 0;  // 重播期間忽略鍵盤
+            } else {
+                if (replaying) {
+                    replaying = false;  // 重播結束，改由玩家繼續
+                    reportReplayResult(replay.getRecording(), game.getStateHash());
+                }
+                input = readHeldKeys();
+                input.buttons |= pendingButtons;
+                pendingButtons = 0;
             }
-
-            // 先檢查勝利條件
-            if (killCount >= 10) {
-                gameWon = true;  // 設置勝利狀態
-                isGameOver = false;  // 確保不會觸發遊戲結束
+            if (recorder) {
+                recorder->recordTick(input);
             }
-            // 再檢查失敗條件
-            else if (currentHealth <= 0) {
-                isGameOver = true;
-                gameWon = false;
+            game.tick(dt, input);
+            ++tickCount;
+            if (game.isPlaying()) {
+                playTime += dt;  // 背景動畫
             }
-
-            // 更新並繪製擊殺數
-            killCountText.setString("Kills: " + std::to_string(killCount) + " | Gold: " + std::to_string(gold));
-            window.draw(killCountText);
-        }
-        else if (gameWon) {
-            // 繪製勝利畫面
-            window.draw(gameWonText);
-            window.draw(victoryPromptText);
-            // 不繪製擊殺數和金幣
+        });
+        if (ticks > 0) {
+            PROFILE_SCOPE("publish snapshot");
+            publishSnapshot();
         }
-        else if (isGameOver) {
-            // 繪製遊戲結束畫面
-            window.draw(gameOverText);
-            window.draw(promptText);
-            // 不繪製擊殺數和金幣
+        profiler.endFrame();
+
+        // 壓力測試：每秒在標題列回報幀率與子彈數量
+        if (stressMode && stressReportClock.getElapsedTime().asSeconds() >= 1.f) {
+            const unsigned int frames = renderedFrames.load(std::memory_order_relaxed);
+            float fps = (frames - stressFramesStart) / stressReportClock.restart().asSeconds();
+            window.setTitle("Stress | bullets: " + std::to_string(game.getBullets().size()) +
+                            " | fps: " + std::to_string(static_cast<int>(fps)) +
+                            " | draw calls: " + std::to_string(renderDrawCalls.load(std::memory_order_relaxed)));
+            stressFramesStart = frames;
         }
 
-        // 在遊戲結束畫面中顯示金幣數量
-        sf::Text goldText("Gold: " + std::to_string(gold), font, 30);
-        goldText.setFillColor(sf::Color::Black);
-        goldText.setPosition(10, 40);  // 調整位置以顯示金幣
-
-        window.display();
+        // 休眠到下一個 tick
+        std::this_thread::sleep_for(std::chrono::duration<float>(timestep.getTimeUntilNextStep()));
+    }
+    renderThread.join();
+    window.close();
+
+    if (recorder) {
+        if (recorder->save(recordPath, game.getStateHash())) {
+            cout << "Recorded " << recorder->getTickCount() << " ticks to " << recordPath << endl;
+        } else {
+            cout << "Error writing input recording: " << recordPath << endl;
+        }
+    }
+    if (profiler.isTracing()) {
+        if (Profiler::writeTrace(tracePath, {&profiler, &renderProfiler})) {
+            cout << "Profile trace written to " << tracePath << " (thread 1: simulation, thread 2: render)" << endl;
+        } else {
+            cout << "Error writing profile trace: " << tracePath << endl;
+        }
+    }
+    if (packRebuild.joinable()) {
+        packRebuild.join();
     }
-
     return 0;
-}
\ No newline at end of file
+}
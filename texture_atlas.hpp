@@ -0,0 +1,273 @@
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 材質圖集：啟動時把多張圖片打包進一張或少數幾張大材質（page），
+// 繪製時只切換 texture rect，減少材質綁定與零散的 GPU 材質。
+// 可以一次 build()，也可以先 plan() 再分多幀 uploadPending()，避免單幀上傳過多
+class TextureAtlas {
+public:
+    struct Region {
+        const sf::Texture* texture = nullptr;
+        sf::IntRect rect;
+    };
+
+private:
+    // pixels 不為空時為外部像素（例如映射的資源包），否則使用 image
+    struct PendingImage {
+        std::string name;
+        sf::Image image;
+        const sf::Uint8* pixels;
+        sf::Vector2u size;
+
+        const sf::Uint8* getPixels() const {
+            return pixels ? pixels : image.getPixelsPtr();
+        }
+    };
+
+    struct Placement {
+        unsigned int page;
+        sf::IntRect rect;
+    };
+
+    struct PendingUpload {
+        PendingImage source;
+        Placement placement;
+    };
+
+    // skyline 打包：記錄目前頁面每一段的高度輪廓
+    struct SkylineSegment {
+        int x, y, width;
+    };
+
+    class SkylinePage {
+    private:
+        int pageWidth, pageHeight;
+        std::vector<SkylineSegment> skyline;
+
+        // 矩形左緣放在第 index 段時的 y；放不下回傳 -1
+        int fitAt(std::size_t index, int w, int h) const {
+            if (skyline[index].x + w > pageWidth) {
+                return -1;
+            }
+            int y = 0;
+            int remaining = w;
+            for (std::size_t i = index; remaining > 0; ++i) {
+                if (i >= skyline.size()) {
+                    return -1;
+                }
+                y = std::max(y, skyline[i].y);
+                if (y + h > pageHeight) {
+                    return -1;
+                }
+                remaining -= skyline[i].width;
+            }
+            return y;
+        }
+
+    public:
+        int usedWidth = 0;
+        int usedHeight = 0;
+
+        SkylinePage(int w, int h) : pageWidth(w), pageHeight(h) {
+            skyline.push_back({0, 0, w});
+        }
+
+        // 以 bottom-left 規則找位置（結果頂端最低者優先，其次最左）
+        bool insert(int w, int h, sf::IntRect& out) {
+            int bestY = -1, bestX = 0;
+            std::size_t bestIndex = 0;
+            for (std::size_t i = 0; i < skyline.size(); ++i) {
+                int y = fitAt(i, w, h);
+                if (y >= 0 && (bestY < 0 || y < bestY || (y == bestY && skyline[i].x < bestX))) {
+                    bestY = y;
+                    bestX = skyline[i].x;
+                    bestIndex = i;
+                }
+            }
+            if (bestY < 0) {
+                return false;
+            }
+
+            // 以新矩形的頂端取代它覆蓋到的輪廓段
+            SkylineSegment placed = {bestX, bestY + h, w};
+            skyline.insert(skyline.begin() + bestIndex, placed);
+            for (std::size_t i = bestIndex + 1; i < skyline.size();) {
+                int overlap = placed.x + placed.width - skyline[i].x;
+                if (overlap <= 0) {
+                    break;
+                }
+                if (overlap >= skyline[i].width) {
+                    skyline.erase(skyline.begin() + i);
+                } else {
+                    skyline[i].x += overlap;
+                    skyline[i].width -= overlap;
+                    break;
+                }
+            }
+            // 合併同高度的相鄰段
+            for (std::size_t i = 0; i + 1 < skyline.size();) {
+                if (skyline[i].y == skyline[i + 1].y) {
+                    skyline[i].width += skyline[i + 1].width;
+                    skyline.erase(skyline.begin() + i + 1);
+                } else {
+                    ++i;
+                }
+            }
+
+            out = sf::IntRect(bestX, bestY, w, h);
+            usedWidth = std::max(usedWidth, bestX + w);
+            usedHeight = std::max(usedHeight, bestY + h);
+            return true;
+        }
+    };
+
+    std::vector<PendingImage> pending;
+    std::deque<PendingUpload> uploads;
+    std::vector<std::unique_ptr<sf::Texture>> pages;
+    std::map<std::string, Placement> placements;
+    unsigned int padding;
+    bool smooth = false;
+
+public:
+    explicit TextureAtlas(unsigned int regionPadding = 1) : padding(regionPadding) {}
+
+    // 加入待打包的圖片；實際打包與上傳在 build() 時進行
+    void add(const std::string& name, sf::Image image) {
+        const sf::Vector2u size = image.getSize();
+        pending.push_back({name, std::move(image), nullptr, size});
+    }
+
+    // 加入外部 RGBA 像素，不複製；像素必須保持有效直到上傳完成
+    void addPixels(const std::string& name, const sf::Uint8* pixels, const sf::Vector2u& size) {
+        pending.push_back({name, sf::Image(), pixels, size});
+    }
+
+    bool addFromFile(const std::string& name, const std::string& path) {
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            return false;
+        }
+        add(name, std::move(image));
+        return true;
+    }
+
+    // 頁面以平滑（雙線性）取樣，圖片縮放繪製時邊緣較平順；之後建立的頁面也套用
+    void setSmooth(bool enabled) {
+        smooth = enabled;
+        for (auto& page : pages) {
+            page->setSmooth(smooth);
+        }
+    }
+
+    // 決定所有待處理圖片的位置並建立頁面材質，圖片排入上傳佇列；
+    // maxPageSize 會再受顯示卡上限限制
+    bool plan(unsigned int maxPageSize = 8192) {
+        const int pageLimit = static_cast<int>(std::min(maxPageSize, sf::Texture::getMaximumSize()));
+
+        // 由高到低排序，skyline 打包的空間利用率較好
+        std::vector<std::size_t> order(pending.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return pending[a].size.y > pending[b].size.y;
+        });
+
+        std::vector<SkylinePage> layouts;
+        std::vector<Placement> placed(pending.size());
+        for (std::size_t index : order) {
+            const sf::Vector2u size = pending[index].size;
+            const int w = static_cast<int>(size.x + padding);
+            const int h = static_cast<int>(size.y + padding);
+            if (w > pageLimit || h > pageLimit) {
+                return false;  // 單張圖片就超過材質上限
+            }
+
+            sf::IntRect rect;
+            bool inserted = false;
+            for (std::size_t page = 0; page < layouts.size() && !inserted; ++page) {
+                if (layouts[page].insert(w, h, rect)) {
+                    placed[index].page = static_cast<unsigned int>(page);
+                    inserted = true;
+                }
+            }
+            if (!inserted) {
+                layouts.emplace_back(pageLimit, pageLimit);
+                layouts.back().insert(w, h, rect);
+                placed[index].page = static_cast<unsigned int>(layouts.size() - 1);
+            }
+            placed[index].rect = sf::IntRect(rect.left, rect.top, static_cast<int>(size.x), static_cast<int>(size.y));
+        }
+
+        // 每頁只配置實際用到的大小
+        const unsigned int firstPage = static_cast<unsigned int>(pages.size());
+        for (std::size_t page = 0; page < layouts.size(); ++page) {
+            std::unique_ptr<sf::Texture> texture(new sf::Texture());
+            if (!texture->create(layouts[page].usedWidth, layouts[page].usedHeight)) {
+                return false;
+            }
+            texture->setSmooth(smooth);
+            pages.push_back(std::move(texture));
+        }
+
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            placed[i].page += firstPage;
+            uploads.push_back({std::move(pending[i]), placed[i]});
+        }
+        pending.clear();
+        return true;
+    }
+
+    // 上傳最多 maxImages 張已規劃的圖片，上傳後才能以 getRegion() 取得；回傳剩餘數量
+    std::size_t uploadPending(std::size_t maxImages = SIZE_MAX) {
+        for (std::size_t i = 0; i < maxImages && !uploads.empty(); ++i) {
+            PendingUpload& upload = uploads.front();
+            pages[upload.placement.page]->update(upload.source.getPixels(), upload.source.size.x, upload.source.size.y,
+                                                 upload.placement.rect.left, upload.placement.rect.top);
+            placements[upload.source.name] = upload.placement;
+            uploads.pop_front();
+        }
+        return uploads.size();
+    }
+
+    // 一次完成打包與上傳
+    bool build(unsigned int maxPageSize = 8192) {
+        if (!plan(maxPageSize)) {
+            return false;
+        }
+        uploadPending();
+        return true;
+    }
+
+    bool contains(const std::string& name) const {
+        return placements.count(name) > 0;
+    }
+
+    Region getRegion(const std::string& name) const {
+        Region region;
+        auto it = placements.find(name);
+        if (it != placements.end()) {
+            region.texture = pages[it->second.page].get();
+            region.rect = it->second.rect;
+        }
+        return region;
+    }
+
+    std::size_t getPageCount() const {
+        return pages.size();
+    }
+
+    const sf::Texture& getPage(std::size_t page) const {
+        return *pages[page];
+    }
+};
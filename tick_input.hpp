@@ -0,0 +1,96 @@
+#pragma once
+
+#include <SFML/Window/Keyboard.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 一個 tick 內的輸入按鍵
+enum InputButton : std::uint8_t {
+    INPUT_LEFT = 1 << 0,
+    INPUT_RIGHT = 1 << 1,
+    INPUT_FIRE = 1 << 2,
+    INPUT_RESTART = 1 << 3,       // 結束畫面重新開始
+    INPUT_DEBUG_KILL = 1 << 4,    // 除錯：增加擊殺數
+    INPUT_DEBUG_DAMAGE = 1 << 5,  // 除錯：扣血
+};
+
+// 模擬每個 tick 只讀取這個結構，不直接查詢鍵盤，
+// 因此可以改用腳本（或錄製的）輸入在沒有視窗的環境執行
+struct TickInput {
+    std::uint8_t buttons = 0;
+
+    bool isDown(std::uint8_t button) const {
+        return (buttons & button) != 0;
+    }
+};
+
+// 目前按住的方向鍵與空白鍵；單次按鍵（例如重新開始）由事件迴圈另外加入
+inline TickInput readHeldKeys() {
+    TickInput input;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) {
+        input.buttons |= INPUT_LEFT;
+    }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) {
+        input.buttons |= INPUT_RIGHT;
+    }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
+        input.buttons |= INPUT_FIRE;
+    }
+    return input;
+}
+
+// 預設腳本：來回移動並持續射擊
+const char* const DEFAULT_INPUT_SCRIPT = "RF:90 LF:180 RF:90";
+
+// 腳本輸入：以空白分隔的「按鍵:tick 數」片段，播完後從頭重複。
+// 按鍵字母 L=左、R=右、F=射擊、-=不按，例如 "RF:90 LF:180 -:30"
+class ScriptedInput {
+private:
+    struct Segment {
+        std::uint8_t buttons;
+        unsigned int ticks;
+    };
+
+    std::vector<Segment> segments;
+    std::size_t segment = 0;
+    unsigned int tickInSegment = 0;
+
+public:
+    explicit ScriptedInput(const std::string& script = DEFAULT_INPUT_SCRIPT) {
+        std::istringstream stream(script);
+        std::string token;
+        while (stream >> token) {
+            const std::size_t colon = token.find(':');
+            Segment parsed = {0, 1};
+            for (std::size_t i = 0; i < token.size() && i < colon; ++i) {
+                switch (token[i]) {
+                    case 'L': parsed.buttons |= INPUT_LEFT; break;
+                    case 'R': parsed.buttons |= INPUT_RIGHT; break;
+                    case 'F': parsed.buttons |= INPUT_FIRE; break;
+                    default: break;
+                }
+            }
+            if (colon != std::string::npos) {
+                parsed.ticks = static_cast<unsigned int>(std::max(1L, std::strtol(token.c_str() + colon + 1, nullptr, 10)));
+            }
+            segments.push_back(parsed);
+        }
+        if (segments.empty()) {
+            segments.push_back({0, 1});
+        }
+    }
+
+    TickInput next() {
+        TickInput input;
+        input.buttons = segments[segment].buttons;
+        if (++tickInSegment >= segments[segment].ticks) {
+            tickInSegment = 0;
+            segment = (segment + 1) % segments.size();
+        }
+        return input;
+    }
+};